@@ -0,0 +1,102 @@
+// Copyright (2018) <BAstian Schiffthaler>
+#include <omp.h>
+#include <fastxio_reader.h>
+#include <fastxio_record.h>
+#include <fastxio_tracks.h>
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/program_options.hpp>
+namespace po = boost::program_options;
+
+int main(int argc, char ** argv)
+{
+  try
+  {
+    uint16_t threads;  // number of threads
+    uint64_t width;  // window width
+    uint64_t step;  // window increment
+    std::string ref;  // reference sequence file
+    std::string prefix;  // output file prefix
+    std::vector<std::string> names;  // tracks to compute
+    bool include_final;
+
+    po::options_description umbrella;
+    po::options_description opt("Options");
+    opt.add_options()
+    ("final,f", po::bool_switch(&include_final)->default_value(false),
+     "Report the final incomplete window of each sequence")
+    ("help,h", "Show this help message")
+    ("step,s", po::value<uint64_t>(&step)->default_value(0),
+     "Window increment (default: the window width)")
+    ("threads,t", po::value<uint16_t>(&threads)->default_value(1),
+     "Number of parallel threads")
+    ("track,T", po::value<std::vector<std::string>>(&names)->multitoken()
+     ->default_value(std::vector<std::string>{"gc", "gc_skew", "cpg_oe",
+                                              "n", "masked"},
+                     "gc gc_skew cpg_oe n masked"),
+     "Tracks to compute")
+    ("width,w", po::value<uint64_t>(&width)->default_value(1000),
+     "Window width");
+
+    po::options_description req("Required");
+    req.add_options()
+    ("ref", po::value<std::string>(&ref)->required(),
+     "Input reference sequence")
+    ("prefix", po::value<std::string>(&prefix)->required(),
+     "Output prefix, tracks are written to <prefix>.<track>.bedGraph");
+
+    umbrella.add(opt).add(req);
+
+    po::positional_options_description p;
+    p.add("ref", 1);
+    p.add("prefix", 1);
+
+    po::variables_map vm;
+    po::store(po::command_line_parser(argc, argv).
+              options(umbrella).positional(p).run(), vm);
+
+    if (vm.count("help") || argc == 1)
+    {
+      std::cerr << umbrella << '\n';
+      return EINVAL;
+    }
+
+    po::notify(vm);
+
+    if (step == 0)
+      step = width;
+    omp_set_num_threads(threads);
+
+    // One bedGraph file per track
+    FASTX::CompositionTracks tracks(width, step, include_final);
+    std::vector<std::unique_ptr<std::ofstream>> outs;
+    for (const std::string& name : names)
+    {
+      FASTX::CompositionTrack t = FASTX::CompositionTracks::parse(name);
+      std::string path = prefix + "." + name + ".bedGraph";
+      outs.emplace_back(new std::ofstream(path.c_str(), std::ios::out));
+      if (! *outs.back())
+        throw std::runtime_error("Could not open " + path);
+      *outs.back() << "track type=bedGraph name=\"" << name << "\"\n";
+      tracks.add(t, *outs.back());
+    }
+
+    // Process one chromosome per thread at a time
+    FASTX::Reader ref_reader(ref.c_str(), DNA_SEQTYPE);
+    std::vector<FASTX::Record> batch;
+    while (ref_reader.next_batch(batch, threads) > 0)
+    {
+      tracks.write(batch);
+    }
+  }
+  catch (std::exception& e)
+  {
+    std::cerr << "Exception occured: " << e.what() << '\n';
+    return 1;
+  }
+
+  return 0;
+}
@@ -21,6 +21,11 @@ int main(int argc, char ** argv)
     std::string cont_out;
     std::string clean_out;
     bool print_stats;
+    bool forward_hash;
+    bool ref_index;  // reference is a saved MinHash index
+    std::string save_index;
+    uint32_t scale;  // FracMinHash scale, 0 for nhash hashes
+    bool containment;
 
     po::options_description umbrella;
     po::options_description opt("Options");
@@ -29,7 +34,16 @@ int main(int argc, char ** argv)
      "Number of records in buffer for parallel processing")
     ("contaminant,c", po::value<std::string>(&cont_out)->default_value(""),
      "Output file for contaminant sequences")
+    ("containment,C", po::bool_switch(&containment)->default_value(false),
+     "Rank references and apply --min-similarity by the fraction of read "
+     "hashes found in the reference instead of the Jaccard index")
+    ("forward-hash,f", po::bool_switch(&forward_hash)->default_value(false),
+     "Hash forward k-mers and index reverse complements as separate "
+     "references instead of using canonical k-mers")
     ("help,h", "Show this help message")
+    ("index,i", po::bool_switch(&ref_index)->default_value(false),
+     "The reference is a MinHash index written with --save-index. Its "
+     "k-mer length, number of hashes and hashing are used")
     ("k-length,k", po::value<uint32_t>(&k)->default_value(13),
      "K-mer length")
     ("min-similarity,m", po::value<double>(&sim_cutoff)->default_value(-1),
@@ -39,6 +53,11 @@ int main(int argc, char ** argv)
     ("out,o", po::value<std::string>(&clean_out)->default_value(""),
      "Output file for clean sequences")
     ("print-stats,s", po::bool_switch(&print_stats)->default_value(false))
+    ("scale,S", po::value<uint32_t>(&scale)->default_value(0),
+     "Keep all hashes below 2^32 / scale (FracMinHash) instead of --nhash "
+     "hashes per sequence, 0 to disable")
+    ("save-index", po::value<std::string>(&save_index)->default_value(""),
+     "Write the reference MinHash index to this file")
     ("threads,t", po::value<uint16_t>(&threads)->default_value(1),
      "Number of parallel threads");
 
@@ -67,14 +86,29 @@ int main(int argc, char ** argv)
 
     po::notify(vm);
 
-    // Create MinHash reference from first file (fasta)
-    FASTX::Reader ref_reader(ref.c_str(), DNA_SEQTYPE);
-    FASTX::MinHash hash(nhash, k);
-    while (ref_reader.peek() != EOF)
+    if (ref_index && save_index != "")
     {
-      FASTX::Record r = ref_reader.next();
-      hash.add(r);
+      std::cerr << "--save-index cannot be used with --index\n";
+      return EINVAL;
+    }
+
+    // Create MinHash reference from first file (fasta), or map an index
+    // that was saved before
+    FASTX::MinHash hash = ref_index ? FASTX::MinHash::open(ref) :
+      FASTX::MinHash(nhash, k, ! forward_hash, scale);
+    if (! ref_index)
+    {
+      FASTX::Reader ref_reader(ref.c_str(), DNA_SEQTYPE);
+      while (ref_reader.peek() != EOF)
+      {
+        FASTX::Record r = ref_reader.next();
+        hash.add(r);
+      }
+      // Queries only compare references sharing a hash with the read
+      hash.build_index();
     }
+    if (save_index != "")
+      hash.save(save_index);
 
     // Prepare to read target sequences into a vector
     // as batches
@@ -114,9 +148,11 @@ int main(int argc, char ** argv)
           #pragma omp task default(shared) firstprivate(seq)
           {
             // Get reference record with best similary to target record
-            auto sim = hash.max_similarity(seq);
+            auto sim = hash.max_similarity(seq, containment);
+            double score = containment ? sim.a_in_b : sim.ji;
             // Write output only one thread at a time
             // target_id  reference_id  hits  nhash_a nhash_b jaccard_similarity
+            // target_in_reference  reference_in_target
             omp_set_lock(&cplock);
             if (print_stats)
             {
@@ -127,10 +163,12 @@ int main(int argc, char ** argv)
               << sim.hits << '\t'
               << sim.asize << '\t'
               << sim.bsize << '\t'
-              << sim.ji << '\n';
+              << sim.ji << '\t'
+              << sim.a_in_b << '\t'
+              << sim.b_in_a << '\n';
             }
             // Write FASTX
-            if (sim.ji > sim_cutoff)
+            if (score > sim_cutoff)
             {
               if (cont_out != "")
               {
@@ -230,25 +230,23 @@ void get_reg_regions(
     }
     if (! no_upstream)
     {
-      FASTX::Record sub = fasta_chr.subseq(left_start - 1, left_end - 1);
-      sub.set_id(sub.get_id() + 
-                 (is_minus ? " type:downstream " : " type:upstream ") +
-                 "strand:" + blocks[i].gene.strand + " " +
-                 blocks[i].gene.attributes.at("ID"));
-      std::cout
-          << FASTX::Wrap(sub)
-          << '\n';
+      FASTX::RecordView sub = fasta_chr.subseq_view(left_start - 1,
+                                                   left_end - 1);
+      sub.write_id(std::cout << '>')
+          << (is_minus ? " type:downstream " : " type:upstream ")
+          << "strand:" << blocks[i].gene.strand << ' '
+          << blocks[i].gene.attributes.at("ID") << '\n';
+      FASTX::Wrap(sub).write_seq(std::cout) << '\n';
     }
     if (! no_downstream)
     {
-      FASTX::Record sub = fasta_chr.subseq(right_start - 1, right_end - 1);
-      sub.set_id(sub.get_id() +
-                 (is_minus ? " type:upstream " : " type:downstream ") +
-                 "strand:" + blocks[i].gene.strand + " " +
-                 blocks[i].gene.attributes.at("ID"));
-      std::cout
-          << FASTX::Wrap(sub)
-          << '\n';
+      FASTX::RecordView sub = fasta_chr.subseq_view(right_start - 1,
+                                                   right_end - 1);
+      sub.write_id(std::cout << '>')
+          << (is_minus ? " type:upstream " : " type:downstream ")
+          << "strand:" << blocks[i].gene.strand << ' '
+          << blocks[i].gene.attributes.at("ID") << '\n';
+      FASTX::Wrap(sub).write_seq(std::cout) << '\n';
     }
     prev_chrom = cur_chrom;
   }
@@ -0,0 +1,94 @@
+// Copyright (2018) <BAstian Schiffthaler>
+#include <omp.h>
+#include <fastxio_reader.h>
+#include <fastxio_record.h>
+#include <fastxio_gaps.h>
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/program_options.hpp>
+namespace po = boost::program_options;
+
+int main(int argc, char ** argv)
+{
+  try
+  {
+    uint16_t threads;  // number of threads
+    uint64_t min_gap;  // shortest N run reported
+    uint64_t min_contig;  // shortest contig written
+    unsigned int width;  // FASTA line width
+    std::string ref;  // reference sequence file
+    std::string bed;  // gap BED file
+    std::string contigs;  // contig FASTA file
+
+    po::options_description umbrella;
+    po::options_description opt("Options");
+    opt.add_options()
+    ("contigs,c", po::value<std::string>(&contigs),
+     "Write the scaffolds split into contigs to this FASTA file")
+    ("help,h", "Show this help message")
+    ("min-contig,l", po::value<uint64_t>(&min_contig)->default_value(1),
+     "Shortest contig to write")
+    ("min-gap,g", po::value<uint64_t>(&min_gap)->default_value(1),
+     "Shortest run of N reported as a gap")
+    ("threads,t", po::value<uint16_t>(&threads)->default_value(1),
+     "Number of parallel threads")
+    ("width,w", po::value<unsigned int>(&width)->default_value(80),
+     "Line width of the contig FASTA, 0 for no wrapping");
+
+    po::options_description req("Required");
+    req.add_options()
+    ("ref", po::value<std::string>(&ref)->required(),
+     "Input reference sequence")
+    ("bed", po::value<std::string>(&bed)->required(),
+     "Output BED file of the gaps");
+
+    umbrella.add(opt).add(req);
+
+    po::positional_options_description p;
+    p.add("ref", 1);
+    p.add("bed", 1);
+
+    po::variables_map vm;
+    po::store(po::command_line_parser(argc, argv).
+              options(umbrella).positional(p).run(), vm);
+
+    if (vm.count("help") || argc == 1)
+    {
+      std::cerr << umbrella << '\n';
+      return EINVAL;
+    }
+
+    po::notify(vm);
+    omp_set_num_threads(threads);
+
+    std::ofstream bed_out(bed.c_str(), std::ios::out);
+    if (! bed_out)
+      throw std::runtime_error("Could not open " + bed);
+    std::unique_ptr<std::ofstream> contig_out;
+    if (vm.count("contigs"))
+    {
+      contig_out.reset(new std::ofstream(contigs.c_str(), std::ios::out));
+      if (! *contig_out)
+        throw std::runtime_error("Could not open " + contigs);
+    }
+
+    // Process one chromosome per thread at a time
+    FASTX::GapFinder finder(min_gap, min_contig);
+    FASTX::Reader ref_reader(ref.c_str(), DNA_SEQTYPE);
+    std::vector<FASTX::Record> batch;
+    while (ref_reader.next_batch(batch, threads) > 0)
+    {
+      finder.write(batch, &bed_out, contig_out.get(), width);
+    }
+  }
+  catch (std::exception& e)
+  {
+    std::cerr << "Exception occured: " << e.what() << '\n';
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,43 @@
+#include <iostream>
+#include <vector>
+#include <fastxio_common.h>
+#include <fastxio_record.h>
+#include <fastxio_reader.h>
+#include <fastxio_adapter.h>
+
+int main(int argc, char ** argv)
+{
+  // Open a file as a reader
+  FASTX::Reader R("p33.fa", DNA_SEQTYPE);
+
+  // Detect the adapter from the first reads
+  std::vector<FASTX::Record> batch;
+  R.next_batch(batch, 10000);
+  int detected = FASTX::AdapterTrimmer::detect(batch);
+
+  // Up to 10% mismatches, trim overlaps of at least 3 bases
+  FASTX::AdapterTrimmer T(0.1, 3);
+  if (detected >= 0)
+    {
+      auto& a = FASTX::AdapterTrimmer::known()[detected];
+      std::cerr << "Detected adapter: " << a.first << std::endl;
+      T.add(a.second, a.first);
+    }
+  else
+    {
+      // Fall back to all known adapters
+      for (auto& a : FASTX::AdapterTrimmer::known())
+	T.add(a.second, a.first);
+    }
+
+  // Trim the sample, then the rest of the file
+  do
+    {
+      T.trim(batch);
+      for (auto& rec : batch)
+	std::cout << rec;
+    }
+  while (R.next_batch(batch, 10000) > 0);
+
+  return 0;
+}
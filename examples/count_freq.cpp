@@ -30,6 +30,10 @@ int main(int argc, char ** argv)
   std::cout << std::setprecision(2) << static_cast<float>( NF['G'] + NF['C'] ) /
     static_cast<float>( NF['G'] + NF['C'] + NF['A'] + NF['T'] ) << "%" << std::endl;
 
+  // Count a whole file in parallel (if built with OpenMP)
+  FASTX::Reader R2("p33.fa", DNA_SEQTYPE);
+  FASTX::NucFrequency all = FASTX::count_freq(R2);
+  std::cout << FASTX::NucPercent(all);
   
   return 0;
 }
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <fastxio_common.h>
 #include <fastxio_record.h>
+#include <fastxio_iupac.h>
 
 int main(int argc, char ** argv)
 {
@@ -21,6 +22,15 @@ int main(int argc, char ** argv)
     {
       std::cout << r << std::endl;
     }
-  
+
+  // Count the expansions of a degenerate primer, then generate them
+  // one at a time without holding them in memory
+  FASTX::Record R3("GTGYCAGCMGCCGCGGTAA", "515F", DNA_SEQTYPE);
+  std::cout << R3.count_iupac() << " expansions" << std::endl;
+  for(FASTX::iupac_enumerator it(R3); ! it.end(); ++it)
+    {
+      std::cout << R3.get_id() << it.suffix() << "\t" << *it << std::endl;
+    }
+
   return 0;
 }
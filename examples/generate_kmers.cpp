@@ -1,6 +1,7 @@
 #include <iostream>
 #include <fastxio_common.h>
 #include <fastxio_record.h>
+#include <fastxio_kmer.h>
 
 int main(int argc, char ** argv)
 {
@@ -19,6 +20,13 @@ int main(int argc, char ** argv)
     {
       std::cout << (*k) << std::endl;
     }
+
+  // Walk along 2-bit encoded kmers without creating records
+  for(auto k = FASTX::kmer_iterator(5, R); ! k.end(); ++k)
+    {
+      std::cout << k.position() << "\t"
+		<< FASTX::decode_kmer(k.canonical(), k.k()) << std::endl;
+    }
   
   return 0;
 }
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <fastxio_common.h>
 #include <fastxio_record.h>
+#include <fastxio_view.h>
 
 int main(int argc, char ** argv)
 {
@@ -25,6 +26,14 @@ int main(int argc, char ** argv)
     {
       std::cout << (*w) << std::endl;
     }
-  
+
+  // Zero-copy views with GC content, updated base by base
+  for(FASTX::window_iterator w(5, 1, R); ! w.end(); ++w)
+    {
+      std::cout << w.start() << "\t" << *w << "\t"
+		<< static_cast<double>(w.counts().gc()) / w.counts().size()
+		<< std::endl;
+    }
+
   return 0;
 }
@@ -0,0 +1,24 @@
+#include <iostream>
+#include <fastxio_common.h>
+#include <fastxio_reader.h>
+#include <fastxio_genstats.h>
+
+int main(int argc, char ** argv)
+{
+  // Statistics for a genome of ~30 kbp, contigs split at 10 or more Ns
+  FASTX::GenomeStats G(30000, 10);
+
+  // Only lengths and base counts are kept, the records are discarded
+  // batch by batch
+  FASTX::Reader R("p33.fa", DNA_SEQTYPE);
+  G.add(R);
+
+  // Individual values
+  std::cout << "N50: " << G.scaffolds().n50 << std::endl;
+  std::cout << "GC: " << G.gc() << "%" << std::endl;
+
+  // Full report
+  G.write(std::cout);
+
+  return 0;
+}
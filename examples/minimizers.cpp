@@ -0,0 +1,31 @@
+#include <iostream>
+#include <fastxio_common.h>
+#include <fastxio_record.h>
+#include <fastxio_kmer.h>
+#include <fastxio_minimizer.h>
+
+int main(int argc, char ** argv)
+{
+
+  // Initialize a Record as DNA
+  FASTX::Record R("ACGTAGCTAGCTAGGATCGATNNACGATCGATCGGCTAGCTAGCATCGA", "Test",
+		  DNA_SEQTYPE);
+
+  // (w = 5, k = 7) minimizers with position and strand
+  for(FASTX::minimizer_iterator m(7, 5, R); ! m.end(); ++m)
+    {
+      std::cout << m->position << "\t" << (m->forward ? '+' : '-') << "\t"
+		<< FASTX::decode_kmer(m->kmer, 7) << std::endl;
+    }
+
+  // Closed syncmers (k = 7, s = 3) of the 2-bit packed sequence
+  FASTX::PackedSequence P(R);
+  for(FASTX::syncmer_iterator s(7, 3, P, FASTX::SyncmerType::CLOSED);
+      ! s.end(); ++s)
+    {
+      std::cout << s->position << "\t" << FASTX::decode_kmer(s->kmer, 7)
+		<< std::endl;
+    }
+
+  return 0;
+}
@@ -39,14 +39,8 @@ int main(int argc, char ** argv)
       // Get the next FASTQ record
       FASTX::Record x = R.next();
 
-      unsigned short qsum = 0; // sum of qualities per read
-      for(unsigned short q : x.get_numeric_qual() )
-	{
-	  qsum += (q - offset);
-	}
       // Save the mean quality of the read
-      quals.push_back( static_cast<float>(qsum) /
-		       static_cast<float>(x.size() ));
+      quals.push_back( x.qual_mean(offset) );
     }
 
   // Sort the data
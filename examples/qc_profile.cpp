@@ -0,0 +1,32 @@
+#include <iostream>
+#include <vector>
+#include <fastxio_common.h>
+#include <fastxio_auxiliary.h> //scan_phred
+#include <fastxio_record.h>
+#include <fastxio_reader.h>
+#include <fastxio_qc.h>
+
+int main(int argc, char ** argv)
+{
+  // Get the PHRED offset
+  unsigned short offset = FASTX::scan_phred("p33.fa");
+
+  // Collect the statistics in batches, in parallel if built with OpenMP
+  FASTX::QcProfile P(offset);
+  FASTX::Reader R("p33.fa", DNA_SEQTYPE);
+  std::vector<FASTX::Record> batch;
+  while (R.next_batch(batch, 4096) > 0)
+    {
+      P.add(batch);
+    }
+
+  // Median quality of the first cycle
+  if (P.cycles() > 0)
+    std::cerr << "Median quality, cycle 1: " << P.quality(0).median
+	      << std::endl;
+
+  // Write everything as JSON
+  P.write_json(std::cout);
+
+  return 0;
+}
@@ -10,6 +10,10 @@ int main(int argc, char ** argv)
 
   // Print the sequence from position 2-5
   std::cout << R.subseq(2,5) << std::endl;
+
+  // The same without copying: the view points into R and the ID is
+  // only assembled when printing
+  std::cout << R.subseq_view(2,5) << std::endl;
   
   return 0;
 }
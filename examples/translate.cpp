@@ -1,6 +1,7 @@
 #include <iostream>
 #include <fastxio_common.h>
 #include <fastxio_record.h>
+#include <fastxio_translate.h>
 
 int main(int argc, char ** argv)
 {
@@ -16,6 +17,33 @@ int main(int argc, char ** argv)
 
   // Print only the first ORF
   std::cout << R.translate(0) << std::endl;
-  
+
+  // Print all six frames using the bacterial genetic code (NCBI table 11)
+  for(auto k : R.translate_six_frame(11) )
+    {
+      std::cout << k << std::endl;
+    }
+
+  // One codon that differs from the standard code per NCBI table
+  struct { unsigned short table; const char * codon; char aa; } checks[] = {
+    {2, "AGA", '*'}, {3, "CTG", 'T'}, {4, "TGA", 'W'}, {5, "AGA", 'S'},
+    {6, "TAA", 'Q'}, {9, "AAA", 'N'}, {10, "TGA", 'C'}, {12, "CTG", 'S'},
+    {13, "AGA", 'G'}, {14, "TAA", 'Y'}, {16, "TAG", 'L'}, {21, "AAA", 'N'},
+    {22, "TCA", '*'}, {23, "TTA", '*'}, {24, "AGG", 'K'}, {24, "ATA", 'I'},
+    {25, "TGA", 'G'}, {26, "CTG", 'A'}, {27, "TAA", 'Q'}, {28, "TAA", 'Q'},
+    {29, "TAA", 'Y'}, {30, "TAA", 'E'}, {31, "TAA", 'E'}, {32, "TAG", 'W'},
+    {33, "TAA", 'Y'}
+  };
+  for (const auto& c : checks)
+    {
+      char aa = FASTX::Translator::get(c.table).codon(c.codon);
+      if (aa != c.aa)
+        {
+          std::cerr << "Table " << c.table << ": " << c.codon << " is "
+                    << aa << ", expected " << c.aa << std::endl;
+          return 1;
+        }
+    }
+
   return 0;
 }
@@ -0,0 +1,37 @@
+#include <iostream>
+#include <vector>
+#include <fastxio_common.h>
+#include <fastxio_auxiliary.h> //scan_phred
+#include <fastxio_record.h>
+#include <fastxio_reader.h>
+#include <fastxio_trim.h>
+
+int main(int argc, char ** argv)
+{
+  // Get the PHRED offset
+  unsigned short offset = FASTX::scan_phred("p33.fa");
+
+  // Configure the trimmer
+  FASTX::Trimmer T(offset);
+  T.set_poly_g(10);
+  T.set_quality(20);
+  T.set_sliding_window(4, 15);
+
+  // Open a file as a reader
+  FASTX::Reader R("p33.fa", DNA_SEQTYPE);
+
+  // Read and trim the file in batches, the records are reused
+  std::vector<FASTX::Record> batch;
+  while (R.next_batch(batch, 1024) > 0)
+    {
+      std::vector<FASTX::trim_t> coords = T.trim(batch);
+      for (size_t i = 0; i < batch.size(); i++)
+	{
+	  std::cerr << batch[i].get_id() << "\t" << coords[i].start << "\t"
+		    << coords[i].end << std::endl;
+	  std::cout << batch[i];
+	}
+    }
+
+  return 0;
+}
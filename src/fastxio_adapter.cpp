@@ -0,0 +1,248 @@
+#include <string>
+#include <vector>
+#include <array>
+#include <utility>
+#include <cstdint>
+#include <stdexcept>
+#include <fastxio_common.h>
+#include <fastxio_record.h>
+#include <fastxio_trim.h>
+#include <fastxio_adapter.h>
+
+namespace FASTX {
+
+namespace {
+
+unsigned allowed_mismatches(double error_rate, length_t overlap)
+{
+  unsigned ret = static_cast<unsigned>(error_rate * overlap + 1e-9);
+  return ret < FASTX_ADAPTER_MAX_MISMATCHES ? ret
+                                            : FASTX_ADAPTER_MAX_MISMATCHES;
+}
+
+// Keep the leftmost match, and the longer one on ties
+void offer(adapter_match_t& best, length_t start, length_t length,
+           unsigned short mismatches, int adapter)
+{
+  if (best.length == 0 || start < best.start ||
+      (start == best.start && length > best.length))
+  {
+    best.start = start;
+    best.length = length;
+    best.mismatches = mismatches;
+    best.adapter = adapter;
+  }
+}
+
+} // anonymous namespace
+
+AdapterTrimmer::AdapterTrimmer(double error_rate, length_t min_overlap) :
+  _error_rate(error_rate), _min_overlap(min_overlap > 0 ? min_overlap : 1)
+{
+#ifndef NO_ERROR_CHECKING
+  if (error_rate < 0 || error_rate >= 1)
+    throw std::runtime_error("The adapter error rate must be in [0, 1)");
+#endif
+}
+
+void AdapterTrimmer::add(const std::string& seq, const std::string& name)
+{
+#ifndef NO_ERROR_CHECKING
+  if (seq.empty())
+    throw std::runtime_error("Empty adapter sequence");
+#endif
+  adapter_t a;
+  a.name = name.empty() ? seq : name;
+  a.seq = seq.size() > 64 ? seq.substr(0, 64) : seq;
+  a.length = a.seq.size();
+  a.mismatches = allowed_mismatches(_error_rate, a.length);
+
+  if (_words.empty() || _words.back().used + a.length > 64)
+  {
+    word_t w;
+    w.mask.fill(0);
+    w.starts = 0;
+    w.ends = 0;
+    w.levels = 0;
+    w.used = 0;
+    _words.push_back(w);
+  }
+  word_t& w = _words.back();
+  a.offset = w.used;
+  w.used += a.length;
+  w.starts |= uint64_t(1) << a.offset;
+  w.ends |= uint64_t(1) << (a.offset + a.length - 1);
+  if (a.mismatches > w.levels)
+    w.levels = a.mismatches;
+  w.adapters.push_back(_adapters.size());
+
+  // A read character matches an adapter position if all bases it stands
+  // for are allowed there, so N in the read only matches N in the adapter
+  for (unsigned c = 0; c < 256; c++)
+  {
+    unsigned char m = GData::iupac_mask[c];
+    for (unsigned short i = 0; i < a.length; i++)
+    {
+      unsigned char am = GData::iupac_mask[static_cast<unsigned char>(a.seq[i])];
+      if (m != 0 && (m & ~am) == 0)
+        w.mask[c] |= uint64_t(1) << (a.offset + i);
+    }
+  }
+  _adapters.push_back(a);
+}
+
+// Shift-and with substitutions: bit i of S[j] is set if the adapter
+// prefix ending at bit i ends at the current base with at most j
+// mismatches. The number of levels is a template parameter so the state
+// words stay in registers.
+template <unsigned K>
+void AdapterTrimmer::scan(const word_t& w, const char * seq, length_t len,
+                          adapter_match_t& best) const
+{
+  uint64_t S[K + 1] = {0};
+  uint64_t pending = w.ends; // Adapters without a full match yet
+  for (length_t i = 0; i < len && pending; i++)
+  {
+    uint64_t b = w.mask[static_cast<unsigned char>(seq[i])];
+    uint64_t prev = S[0];
+    S[0] = ((S[0] << 1) | w.starts) & b;
+    for (unsigned j = 1; j <= K; j++)
+    {
+      uint64_t cur = S[j];
+      S[j] = (((cur << 1) | w.starts) & b) | (prev << 1) | w.starts;
+      prev = cur;
+    }
+    if (S[K] & pending)
+    {
+      for (size_t idx : w.adapters)
+      {
+        const adapter_t& a = _adapters[idx];
+        uint64_t bit = uint64_t(1) << (a.offset + a.length - 1);
+        if (! (pending & bit))
+          continue;
+        unsigned j = 0;
+        while (j <= a.mismatches && ! (S[j] & bit))
+          j++;
+        if (j > a.mismatches)
+          continue;
+        pending &= ~bit;
+        offer(best, i + 1 - a.length, a.length, j, idx);
+      }
+    }
+  }
+
+  // Partial overlaps with the end of the read, longest first
+  for (size_t idx : w.adapters)
+  {
+    const adapter_t& a = _adapters[idx];
+    if (! (pending & (uint64_t(1) << (a.offset + a.length - 1))))
+      continue;
+    length_t l = a.length - 1u < len ? a.length - 1u : len;
+    for (bool found = false; ! found && l >= _min_overlap; l--)
+    {
+      uint64_t bit = uint64_t(1) << (a.offset + l - 1);
+      unsigned allowed = allowed_mismatches(_error_rate, l);
+      for (unsigned j = 0; j <= allowed && j <= K; j++)
+      {
+        if (S[j] & bit)
+        {
+          offer(best, len - l, l, j, idx);
+          found = true;
+          break;
+        }
+      }
+    }
+  }
+}
+
+adapter_match_t AdapterTrimmer::find(const char * seq, length_t len) const
+{
+  adapter_match_t ret;
+  for (auto& w : _words)
+  {
+    switch (w.levels)
+    {
+    case 0: scan<0>(w, seq, len, ret); break;
+    case 1: scan<1>(w, seq, len, ret); break;
+    case 2: scan<2>(w, seq, len, ret); break;
+    case 3: scan<3>(w, seq, len, ret); break;
+    case 4: scan<4>(w, seq, len, ret); break;
+    case 5: scan<5>(w, seq, len, ret); break;
+    case 6: scan<6>(w, seq, len, ret); break;
+    case 7: scan<7>(w, seq, len, ret); break;
+    default: scan<FASTX_ADAPTER_MAX_MISMATCHES>(w, seq, len, ret); break;
+    }
+  }
+  return ret;
+}
+
+trim_t AdapterTrimmer::trim(Record& rec) const
+{
+  trim_t ret;
+  adapter_match_t m = find(rec);
+  ret.end = m.length > 0 ? m.start : rec.size();
+  rec.trim(ret.start, ret.end);
+  return ret;
+}
+
+std::vector<trim_t> AdapterTrimmer::trim(std::vector<Record>& batch) const
+{
+  std::vector<trim_t> ret(batch.size());
+  int64_t n = batch.size();
+  #pragma omp parallel for schedule(static)
+  for (int64_t i = 0; i < n; i++)
+  {
+    ret[i] = trim(batch[i]);
+  }
+  return ret;
+}
+
+const std::vector<std::pair<std::string, std::string>>&
+AdapterTrimmer::known(void)
+{
+  static const std::vector<std::pair<std::string, std::string>> ret = {
+    {"Illumina Universal", "AGATCGGAAGAGC"},
+    {"Nextera", "CTGTCTCTTATACACATCT"},
+    {"Illumina Small RNA", "TGGAATTCTCGG"}
+  };
+  return ret;
+}
+
+int AdapterTrimmer::detect(const std::vector<Record>& sample,
+                           double min_fraction)
+{
+  const std::vector<std::pair<std::string, std::string>>& k = known();
+  std::vector<AdapterTrimmer> matchers;
+  for (auto& a : k)
+  {
+    AdapterTrimmer m(0.1, 12);
+    m.add(a.second.substr(0, 12), a.first);
+    matchers.push_back(m);
+  }
+
+  std::vector<size_t> counts(k.size(), 0);
+  for (auto& rec : sample)
+  {
+    for (size_t i = 0; i < matchers.size(); i++)
+    {
+      if (matchers[i].find(rec).length == 12)
+        counts[i]++;
+    }
+  }
+
+  int ret = -1;
+  size_t best = 0;
+  for (size_t i = 0; i < counts.size(); i++)
+  {
+    if (counts[i] > best)
+    {
+      best = counts[i];
+      ret = i;
+    }
+  }
+  if (sample.empty() || best < min_fraction * sample.size())
+    return -1;
+  return ret;
+}
+
+}
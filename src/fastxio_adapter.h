@@ -0,0 +1,167 @@
+#ifndef _FASTX_IO_ADAPTER_H_
+#define _FASTX_IO_ADAPTER_H_
+
+#include <string>
+#include <vector>
+#include <array>
+#include <utility>
+#include <cstdint>
+#include <fastxio_common.h>
+#include <fastxio_record.h>
+#include <fastxio_trim.h>
+
+// Most mismatches tracked by the bit-parallel matcher
+#define FASTX_ADAPTER_MAX_MISMATCHES 8
+
+namespace FASTX {
+
+/**
+ * @brief An adapter occurrence in a read.
+ */
+struct adapter_match_t
+{
+  length_t start = 0;           /**< Start of the match in the read */
+  length_t length = 0;          /**< Matched length, 0 if there is no match */
+  unsigned short mismatches = 0; /**< Number of mismatches */
+  int adapter = -1;             /**< Index of the adapter, -1 if there is no match */
+};
+
+/**
+ * @brief Find and remove 3' adapters.
+ *
+ * Adapters are matched with a bit-parallel shift-and automaton that
+ * allows substitutions: one 64-bit state word per allowed number of
+ * mismatches is updated per base of the read. Adapters are packed into
+ * the same words as long as their total length is at most 64, so a
+ * handful of adapters is matched in a single pass. Each adapter is searched
+ * for in full anywhere in the read and, failing that, as a partial
+ * overlap of its prefix with the end of the read. The number of allowed
+ * mismatches is `floor(error_rate * overlap)`.
+ *
+ * IUPAC codes in an adapter match all bases they stand for, ambiguous
+ * bases in a read never match. Only the first 64 bases of an adapter are
+ * used.
+ */
+class AdapterTrimmer {
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param error_rate Allowed mismatches per matched base
+   * @param min_overlap Shortest partial overlap at the read end to trim
+   */
+  explicit AdapterTrimmer(double error_rate = 0.1, length_t min_overlap = 3);
+
+  /**
+   * @brief Add an adapter.
+   *
+   * @param seq The adapter sequence (5' to 3')
+   * @param name A name for the adapter
+   */
+  void add(const std::string& seq, const std::string& name = "");
+
+  /**
+   * @brief Number of adapters.
+   */
+  size_t size(void) const { return _adapters.size(); }
+
+  /**
+   * @brief Name of an adapter.
+   *
+   * @param i The index of the adapter, as in `adapter_match_t::adapter`
+   */
+  const std::string& name(size_t i) const { return _adapters.at(i).name; }
+
+  /**
+   * @brief Find the leftmost adapter occurrence in a sequence.
+   *
+   * @param seq Pointer to the sequence
+   * @param len Length of the sequence
+   * @return The match, with a length of 0 if no adapter was found
+   */
+  adapter_match_t find(const char * seq, length_t len) const;
+
+  /**
+   * @brief Find the leftmost adapter occurrence in a record.
+   *
+   * @param rec A record
+   * @return The match, with a length of 0 if no adapter was found
+   */
+  adapter_match_t find(const Record& rec) const {
+    return find(rec.get_seq().data(), rec.size());
+  }
+
+  /**
+   * @brief Remove the adapter and everything after it, in place.
+   *
+   * @param rec A record
+   * @return The kept coordinates [start, end) of the original record
+   */
+  trim_t trim(Record& rec) const;
+
+  /**
+   * @brief Trim a batch of records in place, in parallel if the library
+   * was built with OpenMP.
+   *
+   * @param batch A vector of records
+   * @return The kept coordinates, one per record
+   */
+  std::vector<trim_t> trim(std::vector<Record>& batch) const;
+
+  /**
+   * @brief Commonly used adapters, as (name, sequence) pairs.
+   */
+  static const std::vector<std::pair<std::string, std::string>>& known(void);
+
+  /**
+   * @brief Detect the dominant adapter in a sample of reads.
+   *
+   * Counts the reads that contain the first 12 bases of each of the
+   * `known()` adapters, with at most one mismatch.
+   *
+   * @param sample Records, e.g. the first 100000 reads of a file
+   * @param min_fraction Smallest fraction of reads with the adapter
+   * @return The index of the dominant adapter in `known()`, or -1 if
+   * no adapter was found in enough reads.
+   */
+  static int detect(const std::vector<Record>& sample,
+                    double min_fraction = 0.001);
+
+private:
+  struct adapter_t
+  {
+    std::string name;
+    std::string seq;
+    unsigned short length;
+    unsigned short mismatches;      // Allowed for a full match
+    unsigned short offset;          // First bit in the state word
+  };
+
+  // Several adapters sharing one shift-and automaton
+  struct word_t
+  {
+    std::array<uint64_t, 256> mask; // Positions matching each character
+    uint64_t starts;                // First bit of each adapter
+    uint64_t ends;                  // Last bit of each adapter
+    unsigned short levels;          // Most mismatches of its adapters
+    unsigned short used;            // Number of bits in use
+    std::vector<size_t> adapters;
+  };
+
+  template <unsigned K>
+  void scan(const word_t& w, const char * seq, length_t len,
+            adapter_match_t& best) const;
+
+  double _error_rate;
+  length_t _min_overlap;
+  std::vector<adapter_t> _adapters;
+  std::vector<word_t> _words;
+
+  /**
+   * Examples
+   *  @example adapter_trim.cpp
+   */
+};
+
+}
+#endif
@@ -113,67 +113,18 @@ bool is_bzip2(const char * input)
 // Test if a character is allowed sequence (ACTGN)
 bool is_sequence_char(char test, char seqtype = DNA_SEQTYPE)
 {
-  if ((seqtype & DNA_SEQTYPE) || (seqtype & RNA_SEQTYPE) )
+  unsigned char charclass = global.char_class[static_cast<unsigned char>(test)];
+  if ((seqtype & DNA_SEQTYPE) || (seqtype & RNA_SEQTYPE))
   {
-    if (global.nuc_alphabet.find(test) != global.nuc_alphabet.end())
+    if (charclass & NUC_CHARCLASS)
       return true;
   }
   if (seqtype & AA_SEQTYPE)
   {
-    if (global.aa_alphabet.find(test) != global.aa_alphabet.end())
+    if (charclass & AA_CHARCLASS)
       return true;
   }
   return false;
 }
 
-void recursive_iupac_enum(std::set<Record>& set, Record& rec,
-                          const std::map<char, std::vector<char> >& translation_table,
-                          std::set<char>& unambiguous_nuc)
-{
-  std::cerr << "call\n";
-  bool all_unambiguous = true;
-  size_t position = 0;
-  for (char c : rec.get_seq())
-  {
-#ifndef NO_ERROR_CHECKING
-    c = toupper(c);
-    if (rec.get_type() & AA_SEQTYPE)
-      throw std::runtime_error("Cannot enumerate amino acid record");
-#endif
-    if (unambiguous_nuc.find(c) == unambiguous_nuc.end())
-    {
-      all_unambiguous = false;
-      std::string seq_copy = rec.get_seq();
-      std::string id = rec.get_id();
-      std::string qual;
-      if (rec.get_type() & FASTQ_TYPE)
-        qual = rec.get_qual();
-      for (char r : translation_table.at(c))
-      {
-        std::string tmp_seq(seq_copy);
-        tmp_seq[position] = r;
-        std::string tmp_id = id + "_" + std::to_string(position + 1) + r;
-        if (rec.get_type() & FASTQ_TYPE)
-        {
-          Record R(tmp_seq, tmp_id, qual,
-                   rec.get_type() & DNA_SEQTYPE ? DNA_SEQTYPE : RNA_SEQTYPE);
-          recursive_iupac_enum(set, R, translation_table, unambiguous_nuc);
-        }
-        else
-        {
-          Record R(tmp_seq, tmp_id,
-                   rec.get_type() & DNA_SEQTYPE ? DNA_SEQTYPE : RNA_SEQTYPE);
-          recursive_iupac_enum(set, R, translation_table, unambiguous_nuc);
-        }
-      }
-      position++; break;
-    }
-    else
-    {
-      position++;
-    }
-  }
-  if (all_unambiguous)
-    set.insert(rec);
-}
 };
@@ -78,23 +78,5 @@ bool is_bzip2(const char * input);
  */
 bool is_sequence_char(const char test, char seqtype);
 
-/**
- * @brief Recursively enumerate all possibilities from ambiguous IUPAC DNA/RNA
- * characters.
- *
- * This function not intended for the end user. See rather the
- * `enumerate()` method of the `Record` class.
- *
- * @param set A set containing fully enumerated sequences
- * @param rec The record to be enumerated
- * @param translation_table A table that translates ambiguous
- *        nucleotides to the possibilities
- * @param unambiguous_nuc A set that contains the unambiguous characters
- * @sa    `Record.enumerate()`
- */
-void recursive_iupac_enum(std::set<Record>& set, Record& rec,
-                          const std::map<char, std::vector<char> >& translation_table,
-                          std::set<char>& unambiguous_nuc);
-
 }
 #endif
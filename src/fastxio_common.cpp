@@ -2,6 +2,7 @@
 #include <set>
 #include <map>
 #include <vector>
+#include <cctype>
 #include <fastxio_common.h>
 
 
@@ -24,6 +25,19 @@ const std::set<char> GData::aa_alphabet =  {
   'X', 'x', '*', '-', '.'
 };
 
+static std::array<unsigned char, 256> make_char_class(void)
+{
+  std::array<unsigned char, 256> ret;
+  ret.fill(0);
+  for (char c : GData::nuc_alphabet)
+    ret[static_cast<unsigned char>(c)] |= NUC_CHARCLASS;
+  for (char c : GData::aa_alphabet)
+    ret[static_cast<unsigned char>(c)] |= AA_CHARCLASS;
+  return ret;
+}
+
+const std::array<unsigned char, 256> GData::char_class = make_char_class();
+
 const std::map<char, char> GData::rc =  {
   {'A', 'T'}, {'a', 't'}, {'C', 'G'}, {'c', 'g'},
   {'G', 'C'}, {'g', 'c'}, {'T', 'A'}, {'t', 'a'},
@@ -53,6 +67,46 @@ const std::map<char, std::vector<char> > GData::enum_iupac_rna =  {
   {'N', {'A', 'C', 'U', 'G'}}
 };
 
+static std::array<unsigned char, 256> make_iupac_mask(void)
+{
+  std::array<unsigned char, 256> ret;
+  ret.fill(0);
+  const std::string bases("ACGT");
+  for (size_t i = 0; i < bases.size(); i++)
+  {
+    ret[static_cast<unsigned char>(bases[i])] = 1 << i;
+  }
+  ret['U'] = ret['T'];
+  for (auto& code : GData::enum_iupac_dna)
+  {
+    for (char b : code.second)
+      ret[static_cast<unsigned char>(code.first)] |=
+        ret[static_cast<unsigned char>(b)];
+  }
+  for (int c = 'A'; c <= 'Z'; c++)
+  {
+    ret[std::tolower(c)] = ret[c];
+  }
+  return ret;
+}
+
+const std::array<unsigned char, 256> GData::iupac_mask = make_iupac_mask();
+
+static std::array<unsigned char, 256> make_twobit(void)
+{
+  std::array<unsigned char, 256> ret;
+  ret.fill(4);
+  const std::string bases("ACGTacgt");
+  for (size_t i = 0; i < bases.size(); i++)
+  {
+    ret[static_cast<unsigned char>(bases[i])] = i % 4;
+  }
+  ret['U'] = ret['u'] = 3;
+  return ret;
+}
+
+const std::array<unsigned char, 256> GData::twobit = make_twobit();
+
 const std::map<std::string, char> GData::codon_to_protein_dna =  {
   {"TTT", 'F'}, {"TTC", 'F'}, {"TTA", 'L'}, {"TTG", 'L'},
   {"CTT", 'L'}, {"CTC", 'L'}, {"CTA", 'L'}, {"CTG", 'L'},
@@ -64,7 +118,7 @@ const std::map<std::string, char> GData::codon_to_protein_dna =  {
   {"GCT", 'A'}, {"GCC", 'A'}, {"GCA", 'A'}, {"GCG", 'A'},
   {"TAT", 'Y'}, {"TAC", 'Y'}, {"TAA", '.'}, {"TAG", '.'},
   {"CAT", 'H'}, {"CAC", 'H'}, {"CAA", 'Q'}, {"CAG", 'Q'},
-  {"AAT", 'N'}, {"AAC", 'N'}, {"AAA", 'K'}, {"AAG", 'N'},
+  {"AAT", 'N'}, {"AAC", 'N'}, {"AAA", 'K'}, {"AAG", 'K'},
   {"GAT", 'D'}, {"GAC", 'D'}, {"GAA", 'E'}, {"GAG", 'E'},
   {"TGT", 'C'}, {"TGC", 'C'}, {"TGA", '.'}, {"TGG", 'W'},
   {"CGT", 'R'}, {"CGC", 'R'}, {"CGA", 'R'}, {"CGG", 'R'},
@@ -79,11 +133,11 @@ const std::map<std::string, char> GData::codon_to_protein_rna =  {
   {"GUU", 'V'}, {"GUC", 'V'}, {"GUA", 'V'}, {"GUG", 'V'},
   {"UCU", 'S'}, {"UCC", 'S'}, {"UCA", 'S'}, {"UCG", 'S'},
   {"CCU", 'P'}, {"CCC", 'P'}, {"CCA", 'P'}, {"CCG", 'P'},
-  {"ACU", 'U'}, {"ACC", 'U'}, {"ACA", 'U'}, {"ACG", 'U'},
+  {"ACU", 'T'}, {"ACC", 'T'}, {"ACA", 'T'}, {"ACG", 'T'},
   {"GCU", 'A'}, {"GCC", 'A'}, {"GCA", 'A'}, {"GCG", 'A'},
   {"UAU", 'Y'}, {"UAC", 'Y'}, {"UAA", '.'}, {"UAG", '.'},
   {"CAU", 'H'}, {"CAC", 'H'}, {"CAA", 'Q'}, {"CAG", 'Q'},
-  {"AAU", 'N'}, {"AAC", 'N'}, {"AAA", 'K'}, {"AAG", 'N'},
+  {"AAU", 'N'}, {"AAC", 'N'}, {"AAA", 'K'}, {"AAG", 'K'},
   {"GAU", 'D'}, {"GAC", 'D'}, {"GAA", 'E'}, {"GAG", 'E'},
   {"UGU", 'C'}, {"UGC", 'C'}, {"UGA", '.'}, {"UGG", 'W'},
   {"CGU", 'R'}, {"CGC", 'R'}, {"CGA", 'R'}, {"CGG", 'R'},
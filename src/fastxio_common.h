@@ -9,6 +9,7 @@
 #define _FASTX_IO_COMMON_H_
 
 #include <string>
+#include <array>
 #include <set>
 #include <map>
 #include <vector>
@@ -27,6 +28,9 @@
 #define RNA_SEQTYPE 8
 #define AA_SEQTYPE 16
 
+#define NUC_CHARCLASS 1
+#define AA_CHARCLASS 2
+
 #ifdef __GNU__
 #ifndef PARALLEL_SORT
 #include <parallel/algorithm>
@@ -56,6 +60,29 @@ typedef unsigned long length_t;
  */
 typedef long int score_t;
 
+/**
+ * @brief Amount of validation performed on records.
+ *
+ * Each level includes all checks of the levels before it.
+ */
+enum class ValidationPolicy
+{
+  NONE,       /**< No validation */
+  STRUCTURAL, /**< Header markers, sequence and quality lengths */
+  ALPHABET,   /**< Sequence characters against the alphabet of the type */
+  FULL        /**< Quality values in the allowed range */
+};
+
+/**
+ * @brief Validation policy used if none is given. Compiling with
+ * `NO_ERROR_CHECKING` turns validation off by default.
+ */
+#ifdef NO_ERROR_CHECKING
+const ValidationPolicy default_validation = ValidationPolicy::NONE;
+#else
+const ValidationPolicy default_validation = ValidationPolicy::FULL;
+#endif
+
 template<typename T>
 double lexical_double(T arg)
 {
@@ -77,6 +104,25 @@ struct GData
    */
   static const std::set<char> aa_alphabet;
 
+  /**
+   * @brief Byte class table, flags NUC_CHARCLASS and AA_CHARCLASS for every
+   * character of the nucleotide and amino acid alphabets.
+   */
+  static const std::array<unsigned char, 256> char_class;
+
+  /**
+   * @brief IUPAC nucleotide codes as 4-bit masks (A = 1, C = 2, G = 4,
+   * T/U = 8, ambiguous codes are the union of their bases, all other
+   * characters are 0).
+   */
+  static const std::array<unsigned char, 256> iupac_mask;
+
+  /**
+   * @brief 2-bit nucleotide codes (A = 0, C = 1, G = 2, T/U = 3, in
+   * either case), all other characters are 4.
+   */
+  static const std::array<unsigned char, 256> twobit;
+
   /**
    * @brief Reverse complementation table
    */
@@ -0,0 +1,95 @@
+#include <string>
+#include <vector>
+#include <sstream>
+#include <cstdint>
+#include <fastxio_common.h>
+#include <fastxio_record.h>
+#include <fastxio_simd.h>
+#include <fastxio_gaps.h>
+
+namespace FASTX {
+
+GapFinder::GapFinder(length_t min_gap, length_t min_contig) :
+  _min_gap(min_gap > 0 ? min_gap : 1), _min_contig(min_contig)
+{
+}
+
+std::vector<gap_t> GapFinder::gaps(const char * seq, length_t len) const
+{
+  std::vector<gap_t> ret;
+  length_t i = 0;
+  while (i < len)
+  {
+    i += first_n(seq + i, len - i);
+    if (i == len)
+      break;
+    gap_t g;
+    g.start = i;
+    i += first_not_n(seq + i, len - i);
+    g.end = i;
+    if (g.end - g.start >= _min_gap)
+      ret.push_back(g);
+  }
+  return ret;
+}
+
+std::vector<RecordView> GapFinder::contigs(const Record& r) const
+{
+  std::vector<RecordView> ret;
+  length_t start = 0;
+  for (const gap_t& g : gaps(r))
+  {
+    if (g.start > start && g.start - start >= _min_contig)
+      ret.push_back(r.subseq_view(start, g.start - 1).as_region());
+    start = g.end;
+  }
+  if (r.size() > start && r.size() - start >= _min_contig)
+    ret.push_back(r.subseq_view(start, r.size() - 1).as_region());
+  return ret;
+}
+
+std::string GapFinder::bed(const Record& r) const
+{
+  std::ostringstream out;
+  header_field_t chrom = r.get_name();
+  for (const gap_t& g : gaps(r))
+    out << chrom << '\t' << g.start << '\t' << g.end << '\n';
+  return out.str();
+}
+
+void GapFinder::write(const std::vector<Record>& batch, std::ostream * bed_out,
+                      std::ostream * contig_out, unsigned int width) const
+{
+  std::vector<std::string> beds(batch.size());
+  std::vector<std::string> fastas(batch.size());
+  int64_t n = batch.size();
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (int64_t i = 0; i < n; i++)
+  {
+    if (bed_out)
+      beds[i] = bed(batch[i]);
+    if (contig_out)
+    {
+      std::ostringstream out;
+      // FASTQ records cannot be wrapped
+      bool wrap = width > 0 && (batch[i].get_type() & FASTA_TYPE);
+      for (const RecordView& c : contigs(batch[i]))
+      {
+        if (wrap)
+          out << Wrap(c, width) << '\n';
+        else
+          out << c << '\n';
+      }
+      fastas[i] = out.str();
+    }
+  }
+  for (size_t i = 0; i < batch.size(); i++)
+  {
+    if (bed_out)
+      *bed_out << beds[i];
+    if (contig_out)
+      *contig_out << fastas[i];
+  }
+}
+
+}
@@ -0,0 +1,97 @@
+#ifndef _FASTX_IO_GAPS_H_
+#define _FASTX_IO_GAPS_H_
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <fastxio_common.h>
+#include <fastxio_record.h>
+
+namespace FASTX {
+
+/**
+ * @brief A run of N in a sequence, [start, end)
+ */
+struct gap_t
+{
+  length_t start = 0;
+  length_t end = 0;
+};
+
+/**
+ * @brief Scaffold gap finder and contig splitter
+ *
+ * Gaps are runs of N (or n) of at least `min_gap` bases, found with the
+ * vectorized `first_n()` and `first_not_n()` kernels. Gaps are reported
+ * in BED format (0-based, half-open). Contigs are the parts of a scaffold
+ * between gaps and are returned as views (see `RecordView::as_region()`),
+ * their IDs are "name:start-end comment" with the 1-based, inclusive
+ * coordinates in the scaffold, so each contig has a unique name.
+ */
+class GapFinder
+{
+public:
+  /**
+   * @brief Constructor
+   *
+   * @param min_gap The shortest run of N reported as a gap
+   * @param min_contig The shortest contig reported by `contigs()`
+   */
+  GapFinder(length_t min_gap = 1, length_t min_contig = 1);
+
+  /**
+   * @brief Find the gaps of a sequence
+   *
+   * @param seq Pointer to the sequence
+   * @param len Length of the sequence
+   * @return The gaps, ordered by position
+   */
+  std::vector<gap_t> gaps(const char * seq, length_t len) const;
+
+  /**
+   * @brief Find the gaps of a record
+   *
+   * @param r A record
+   * @return The gaps, ordered by position
+   */
+  std::vector<gap_t> gaps(const Record& r) const {
+    return gaps(r.get_seq().data(), r.size());
+  }
+
+  /**
+   * @brief Split a scaffold into contigs at its gaps
+   *
+   * @param r A record, it must outlive the returned views
+   * @return Views of the contigs, ordered by position
+   */
+  std::vector<RecordView> contigs(const Record& r) const;
+
+  /**
+   * @brief The gaps of a record in BED format
+   *
+   * @param r A record, the chromosome name is its canonical ID
+   * @return One BED line per gap
+   */
+  std::string bed(const Record& r) const;
+
+  /**
+   * @brief Find and write the gaps and contigs of a batch of records
+   *
+   * Records are processed in parallel if the library was built with
+   * OpenMP and written in the order of the batch.
+   *
+   * @param batch A vector of records, e.g. from `Reader::next_batch()`
+   * @param bed_out The stream the gaps are written to, or nullptr
+   * @param contig_out The stream the contigs are written to, or nullptr
+   * @param width The column width of FASTA contigs, 0 for no wrapping
+   */
+  void write(const std::vector<Record>& batch, std::ostream * bed_out,
+             std::ostream * contig_out = nullptr, unsigned int width = 80) const;
+
+private:
+  length_t _min_gap;
+  length_t _min_contig;
+};
+
+}
+#endif
@@ -0,0 +1,177 @@
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <ostream>
+#include <cstdint>
+#include <fastxio_common.h>
+#include <fastxio_record.h>
+#include <fastxio_reader.h>
+#include <fastxio_nuc_frequency.h>
+#include <fastxio_simd.h>
+#include <fastxio_genstats.h>
+
+namespace FASTX {
+
+namespace {
+
+void write_stats(std::ostream& out, const std::string& prefix,
+                 const length_stats_t& s, bool ng50)
+{
+  out << prefix << "_count\t" << s.count << '\n'
+      << prefix << "_total\t" << s.total << '\n'
+      << prefix << "_shortest\t" << s.shortest << '\n'
+      << prefix << "_longest\t" << s.longest << '\n'
+      << prefix << "_mean\t" << s.mean << '\n'
+      << prefix << "_N50\t" << s.n50 << '\n'
+      << prefix << "_L50\t" << s.l50 << '\n'
+      << prefix << "_N90\t" << s.n90 << '\n'
+      << prefix << "_L90\t" << s.l90 << '\n';
+  if (ng50)
+    out << prefix << "_NG50\t" << s.ng50 << '\n'
+        << prefix << "_LG50\t" << s.lg50 << '\n';
+}
+
+} // anonymous namespace
+
+GenomeStats::GenomeStats(uint64_t genome_size, length_t min_gap) :
+  _genome_size(genome_size), _min_gap(min_gap > 0 ? min_gap : 1),
+  _gaps(0), _gap_length(0)
+{
+}
+
+void GenomeStats::add(const Record& r)
+{
+  const std::string& seq = r.get_seq();
+  const length_t len = seq.size();
+  _scaffolds.push_back(len);
+  _nuc_freq.add(r);
+
+  // Split into contigs at runs of N
+  const char * data = seq.data();
+  length_t contig_start = 0;
+  length_t i = 0;
+  while (i < len)
+  {
+    i += first_n(data + i, len - i);
+    if (i == len)
+      break;
+    length_t run_start = i;
+    i += first_not_n(data + i, len - i);
+    if (i - run_start < _min_gap)
+      continue;
+    if (run_start > contig_start)
+      _contigs.push_back(run_start - contig_start);
+    _gaps++;
+    _gap_length += i - run_start;
+    contig_start = i;
+  }
+  if (len > contig_start)
+    _contigs.push_back(len - contig_start);
+}
+
+void GenomeStats::add(const std::vector<Record>& batch)
+{
+  int64_t n = batch.size();
+  #pragma omp parallel
+  {
+    GenomeStats local(_genome_size, _min_gap);
+    #pragma omp for schedule(dynamic, 1)
+    for (int64_t i = 0; i < n; i++)
+    {
+      local.add(batch[i]);
+    }
+    #pragma omp critical
+    merge(local);
+  }
+}
+
+void GenomeStats::add(Reader& reader, size_t batch_size)
+{
+  std::vector<Record> batch;
+  while (reader.next_batch(batch, batch_size) > 0)
+  {
+    add(batch);
+  }
+}
+
+void GenomeStats::merge(const GenomeStats& other)
+{
+  _nuc_freq.merge(other._nuc_freq);
+  _scaffolds.insert(_scaffolds.end(), other._scaffolds.begin(),
+                    other._scaffolds.end());
+  _contigs.insert(_contigs.end(), other._contigs.begin(),
+                  other._contigs.end());
+  _gaps += other._gaps;
+  _gap_length += other._gap_length;
+}
+
+length_stats_t GenomeStats::stats(std::vector<length_t>& lengths,
+                                  uint64_t genome_size)
+{
+  length_stats_t ret;
+  if (lengths.empty())
+    return ret;
+  std::sort(lengths.begin(), lengths.end(), std::greater<length_t>());
+  ret.count = lengths.size();
+  for (length_t l : lengths)
+    ret.total += l;
+  ret.longest = lengths.front();
+  ret.shortest = lengths.back();
+  ret.mean = static_cast<double>(ret.total) / ret.count;
+
+  // Cumulative lengths from the longest sequence down
+  uint64_t cum = 0;
+  for (size_t i = 0; i < lengths.size(); i++)
+  {
+    cum += lengths[i];
+    if (ret.l50 == 0 && 2 * cum >= ret.total)
+    {
+      ret.n50 = lengths[i];
+      ret.l50 = i + 1;
+    }
+    if (ret.l90 == 0 && 10 * cum >= 9 * ret.total)
+    {
+      ret.n90 = lengths[i];
+      ret.l90 = i + 1;
+    }
+    if (genome_size > 0 && ret.lg50 == 0 && 2 * cum >= genome_size)
+    {
+      ret.ng50 = lengths[i];
+      ret.lg50 = i + 1;
+    }
+  }
+  return ret;
+}
+
+length_stats_t GenomeStats::scaffolds(void) const
+{
+  std::vector<length_t> lengths(_scaffolds);
+  return stats(lengths, _genome_size);
+}
+
+length_stats_t GenomeStats::contigs(void) const
+{
+  std::vector<length_t> lengths(_contigs);
+  return stats(lengths, _genome_size);
+}
+
+double GenomeStats::gc(void) const
+{
+  const NucFrequency& f = _nuc_freq;
+  uint64_t gc = f['G'] + f['C'] + f['g'] + f['c'];
+  uint64_t all = gc + f['A'] + f['T'] + f['U'] + f['a'] + f['t'] + f['u'];
+  return all ? 100.0 * gc / all : 0.0;
+}
+
+void GenomeStats::write(std::ostream& out) const
+{
+  write_stats(out, "scaffold", scaffolds(), _genome_size > 0);
+  write_stats(out, "contig", contigs(), _genome_size > 0);
+  out << "gaps\t" << _gaps << '\n'
+      << "gap_length\t" << _gap_length << '\n'
+      << "N\t" << _nuc_freq['N'] + _nuc_freq['n'] << '\n'
+      << "GC\t" << gc() << '\n';
+}
+
+}
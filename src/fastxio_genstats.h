@@ -0,0 +1,157 @@
+#ifndef _FASTX_IO_GENOME_STATS_H_
+#define _FASTX_IO_GENOME_STATS_H_
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstdint>
+#include <fastxio_common.h>
+#include <fastxio_nuc_frequency.h>
+
+namespace FASTX {
+
+// Forward declarations
+class Record;
+class Reader;
+
+/**
+ * @brief Length statistics of a set of sequences
+ */
+struct length_stats_t
+{
+  uint64_t count = 0;
+  uint64_t total = 0;
+  length_t shortest = 0;
+  length_t longest = 0;
+  double mean = 0;
+  length_t n50 = 0;  /**< Length of the sequence reaching 50% of the total */
+  uint64_t l50 = 0;  /**< Number of sequences reaching 50% of the total */
+  length_t n90 = 0;
+  uint64_t l90 = 0;
+  length_t ng50 = 0; /**< As N50, of the genome size, 0 if not reached */
+  uint64_t lg50 = 0;
+};
+
+/**
+ * @brief Compute and store genome statistics.
+ *
+ * Every sequence added is reduced to its length, the lengths of its
+ * contigs and its base counts, so memory use depends on the number of
+ * sequences, not on their size. Scaffolds are split into contigs at runs
+ * of N (or n) of at least `min_gap` bases. Statistics of different threads
+ * are combined with `merge()`, `add()` on a batch or a `Reader` does this
+ * internally.
+ */
+class GenomeStats {
+public:
+  /**
+   * @brief Constructor
+   *
+   * @param genome_size The (estimated) genome size for NG50, 0 to skip
+   * @param min_gap The shortest run of N that separates two contigs
+   */
+  GenomeStats(uint64_t genome_size = 0, length_t min_gap = 1);
+
+  /**
+   * @brief Add a sequence (scaffold)
+   *
+   * @param r A record
+   */
+  void add(const Record& r);
+
+  /**
+   * @brief Add a batch of sequences
+   *
+   * Records are processed in parallel if the library was built with
+   * OpenMP.
+   *
+   * @param batch A vector of records
+   */
+  void add(const std::vector<Record>& batch);
+
+  /**
+   * @brief Add all sequences of a reader, batch by batch
+   *
+   * @param reader A reader, it is consumed to the end
+   * @param batch_size The number of records held in memory at once
+   */
+  void add(Reader& reader, size_t batch_size = 64);
+
+  /**
+   * @brief Add the statistics of another object
+   *
+   * @param other Statistics of other sequences, e.g. of another thread
+   */
+  void merge(const GenomeStats& other);
+
+  /**
+   * @brief Add the statistics of another object, see `merge()`
+   */
+  GenomeStats& operator+=(const GenomeStats& other) {
+    merge(other);
+    return *this;
+  }
+
+  /**
+   * @brief Length statistics of the sequences as they were added
+   */
+  length_stats_t scaffolds(void) const;
+
+  /**
+   * @brief Length statistics of the contigs, the scaffolds split at gaps
+   */
+  length_stats_t contigs(void) const;
+
+  /**
+   * @brief GC content in percent of all A, C, G, T/U bases (any case)
+   */
+  double gc(void) const;
+
+  /**
+   * @brief Number of gaps (N runs of at least `min_gap` bases)
+   */
+  uint64_t gaps(void) const { return _gaps; }
+
+  /**
+   * @brief Total length of all gaps
+   */
+  uint64_t gap_length(void) const { return _gap_length; }
+
+  /**
+   * @brief Character counts of all sequences
+   */
+  const NucFrequency& nuc_freq(void) const { return _nuc_freq; }
+
+  /**
+   * @brief Write a report, one "name<TAB>value" line per statistic
+   *
+   * @param outstream The output stream
+   */
+  void write(std::ostream& outstream) const;
+
+  /**
+   * @brief Length statistics of a set of lengths
+   *
+   * @param lengths The lengths, they are sorted in place
+   * @param genome_size The genome size for NG50, 0 to skip
+   */
+  static length_stats_t stats(std::vector<length_t>& lengths,
+                              uint64_t genome_size = 0);
+
+private:
+  uint64_t _genome_size;
+  length_t _min_gap;
+  NucFrequency _nuc_freq;
+  std::vector<length_t> _scaffolds;
+  std::vector<length_t> _contigs;
+  uint64_t _gaps;
+  uint64_t _gap_length;
+
+  /**
+   * Examples
+   *  @example genome_stats.cpp
+   */
+};
+
+}
+#endif
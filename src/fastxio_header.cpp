@@ -0,0 +1,153 @@
+#include <cstdint>
+#include <fastxio_common.h>
+#include <fastxio_header.h>
+
+namespace FASTX {
+
+namespace {
+
+// Whitespace and control characters end the name
+inline bool is_separator(char c)
+{
+  return static_cast<unsigned char>(c) <= ' ' || c == 127;
+}
+
+// Unsigned decimal number filling the whole field
+bool parse_uint(const char * s, length_t len, uint32_t& value)
+{
+  if (len == 0 || len > 10)
+    return false;
+  uint64_t v = 0;
+  for (length_t i = 0; i < len; i++)
+  {
+    if (s[i] < '0' || s[i] > '9')
+      return false;
+    v = v * 10 + (s[i] - '0');
+  }
+  if (v > UINT32_MAX)
+    return false;
+  value = static_cast<uint32_t>(v);
+  return true;
+}
+
+bool parse_uint(const header_field_t& f, uint32_t& value)
+{
+  return parse_uint(f.data, f.size, value);
+}
+
+// Split at a delimiter into at most n fields, returns the number found
+unsigned split(const header_field_t& f, char delim, header_field_t * fields,
+               unsigned n)
+{
+  unsigned found = 0;
+  length_t start = 0;
+  for (length_t i = 0; i <= f.size; i++)
+  {
+    if (i < f.size && f.data[i] != delim)
+      continue;
+    if (found == n)
+      return n + 1;
+    fields[found].data = f.data + start;
+    fields[found].size = i - start;
+    found++;
+    start = i + 1;
+  }
+  return found;
+}
+
+bool parse_casava18(const header_field_t& name, const header_field_t& comment,
+                    illumina_header_t& h)
+{
+  header_field_t f[8];
+  unsigned n = split(name, ':', f, 8);
+  if (n != 7 && n != 8)
+    return false;
+  h.instrument = f[0];
+  h.flowcell = f[2];
+  if (! parse_uint(f[1], h.run) || ! parse_uint(f[3], h.lane) ||
+      ! parse_uint(f[4], h.tile) || ! parse_uint(f[5], h.x) ||
+      ! parse_uint(f[6], h.y))
+    return false;
+  if (n == 8)
+    h.umi = f[7];
+  h.legacy = false;
+  if (comment.empty())
+    return true;
+
+  // Only the first token of the comment belongs to the read
+  header_field_t c = comment;
+  c.size = header_name_length(c.data, c.size);
+  header_field_t g[4];
+  if (split(c, ':', g, 4) != 4)
+    return false;
+  if (! parse_uint(g[0], h.read) || ! parse_uint(g[2], h.control))
+    return false;
+  if (g[1].size != 1 || (g[1].data[0] != 'Y' && g[1].data[0] != 'N'))
+    return false;
+  h.filtered = g[1].data[0] == 'Y';
+  h.index = g[3];
+  return true;
+}
+
+bool parse_legacy(const header_field_t& name, illumina_header_t& h)
+{
+  header_field_t f[5];
+  if (split(name, ':', f, 5) != 5)
+    return false;
+  // The last field is y, optionally followed by #index and /read
+  header_field_t& y = f[4];
+  length_t y_len = 0;
+  while (y_len < y.size && y.data[y_len] != '#' && y.data[y_len] != '/')
+    y_len++;
+  length_t pos = y_len;
+  if (pos < y.size && y.data[pos] == '#')
+  {
+    length_t start = ++pos;
+    while (pos < y.size && y.data[pos] != '/')
+      pos++;
+    h.index.data = y.data + start;
+    h.index.size = pos - start;
+  }
+  if (pos < y.size)
+  {
+    if (! parse_uint(y.data + pos + 1, y.size - pos - 1, h.read))
+      return false;
+  }
+  h.instrument = f[0];
+  if (! parse_uint(f[1], h.lane) || ! parse_uint(f[2], h.tile) ||
+      ! parse_uint(f[3], h.x) || ! parse_uint(y.data, y_len, h.y))
+    return false;
+  h.legacy = true;
+  return true;
+}
+
+} // anonymous namespace
+
+length_t header_name_length(const char * id, length_t len)
+{
+  length_t i = 0;
+  while (i < len && ! is_separator(id[i]))
+    i++;
+  return i;
+}
+
+length_t header_comment_start(const char * id, length_t len,
+                              length_t name_len)
+{
+  length_t i = name_len;
+  while (i < len && is_separator(id[i]))
+    i++;
+  return i;
+}
+
+bool parse_illumina(const header_field_t& name, const header_field_t& comment,
+                    illumina_header_t& h)
+{
+  h = illumina_header_t();
+  if (parse_casava18(name, comment, h))
+    return true;
+  h = illumina_header_t();
+  return parse_legacy(name, h);
+}
+
+}
@@ -0,0 +1,119 @@
+#ifndef _FASTX_IO_HEADER_H_
+#define _FASTX_IO_HEADER_H_
+
+#include <string>
+#include <cstdint>
+#include <ostream>
+#include <fastxio_common.h>
+
+namespace FASTX {
+
+/**
+ * @brief A non-owning view of a part of a header line
+ *
+ * Only valid as long as the header it points into is alive and unchanged.
+ */
+struct header_field_t
+{
+  const char * data = nullptr;
+  length_t size = 0;
+
+  /**
+   * @brief Check if the field is empty (or absent)
+   */
+  bool empty(void) const { return size == 0; }
+
+  /**
+   * @brief Copy the field
+   */
+  std::string str(void) const {
+    return data ? std::string(data, size) : std::string();
+  }
+
+  /**
+   * @brief Compare the field to a string
+   */
+  bool operator==(const std::string& s) const {
+    return s.size() == size && s.compare(0, size, data, size) == 0;
+  }
+};
+
+/**
+ * @brief Print a header field
+ */
+inline std::ostream& operator<<(std::ostream& outstream,
+                                const header_field_t& f)
+{
+  return outstream.write(f.data, f.size);
+}
+
+/**
+ * @brief The fields of an Illumina read header
+ *
+ * Two formats are recognized, the one written since CASAVA 1.8
+ *
+ *     @<instrument>:<run>:<flowcell>:<lane>:<tile>:<x>:<y>[:<umi>] <read>:<filtered>:<control>:<index>
+ *
+ * and the older one
+ *
+ *     @<instrument>:<lane>:<tile>:<x>:<y>[#<index>][/<read>]
+ *
+ * Fields missing from a format are left empty or 0. The text fields
+ * point into the header.
+ */
+struct illumina_header_t
+{
+  header_field_t instrument;
+  uint32_t run = 0;
+  header_field_t flowcell;
+  uint32_t lane = 0;
+  uint32_t tile = 0;
+  uint32_t x = 0;
+  uint32_t y = 0;
+  header_field_t umi;
+  uint32_t read = 0;       /**< Read number, 1 or 2, 0 if unknown */
+  bool filtered = false;   /**< Read was filtered (Y in the comment) */
+  uint32_t control = 0;    /**< Control bits, 0 if not a control */
+  header_field_t index;    /**< Index sequence(s) or sample number */
+  bool legacy = false;     /**< True for the pre-CASAVA 1.8 format */
+};
+
+/**
+ * @brief Length of the name of a header, the part up to the first
+ * whitespace or non printing character
+ *
+ * @param id Pointer to the header, without '>' or '@'
+ * @param len Length of the header
+ * @return The length of the name
+ */
+length_t header_name_length(const char * id, length_t len);
+
+/**
+ * @brief Start of the comment of a header, the position after the
+ * whitespace following the name
+ *
+ * @param id Pointer to the header, without '>' or '@'
+ * @param len Length of the header
+ * @param name_len The length of the name, see `header_name_length()`
+ * @return The position of the comment, `len` if there is none
+ */
+length_t header_comment_start(const char * id, length_t len,
+                              length_t name_len);
+
+/**
+ * @brief Parse an Illumina header
+ *
+ * Nothing is allocated, the text fields of `h` point into `name` and
+ * `comment`.
+ *
+ * @param name The name (first token) of the header
+ * @param comment The comment (rest) of the header, may be empty
+ * @param h Set to the parsed fields
+ * @return False if the header is not in one of the Illumina formats, `h`
+ * is undefined in that case
+ */
+bool parse_illumina(const header_field_t& name, const header_field_t& comment,
+                    illumina_header_t& h);
+
+}
+#endif
@@ -0,0 +1,130 @@
+#include <string>
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <fastxio_common.h>
+#include <fastxio_record.h>
+#include <fastxio_iupac.h>
+
+namespace FASTX {
+
+namespace {
+
+unsigned char popcount4(unsigned char m)
+{
+  return (m & 1) + ((m >> 1) & 1) + ((m >> 2) & 1) + ((m >> 3) & 1);
+}
+
+void invalid_char(char c)
+{
+  throw std::runtime_error(std::string("Cannot enumerate character: ") + c);
+}
+
+} // anonymous namespace
+
+iupac_enumerator::iupac_enumerator(const char * seq, length_t len, bool rna) :
+  _seq(seq, len), _kmer(0), _end(false)
+{
+  const char upper[4] = {'A', 'C', 'G', rna ? 'U' : 'T'};
+  for (length_t i = 0; i < len; i++)
+  {
+    unsigned char m = GData::iupac_mask[static_cast<unsigned char>(seq[i])];
+    if (m == 0)
+      invalid_char(seq[i]);
+    if (popcount4(m) == 1)
+      continue;
+    bool lower = seq[i] >= 'a';
+    std::array<char, 4> c;
+    unsigned char n = 0;
+    for (unsigned char b = 0; b < 4; b++)
+    {
+      if (m & (1 << b))
+        c[n++] = lower ? upper[b] | 0x20 : upper[b];
+    }
+    _pos.push_back(i);
+    _choices.push_back(c);
+    _nchoices.push_back(n);
+    _digit.push_back(0);
+    _seq[i] = c[0];
+  }
+  if (len <= 32)
+  {
+    for (char c : _seq)
+      _kmer = (_kmer << 2) | GData::twobit[static_cast<unsigned char>(c)];
+  }
+}
+
+iupac_enumerator::iupac_enumerator(const Record& r) :
+  iupac_enumerator(r.get_seq().data(), r.size(),
+                   (r.get_type() & RNA_SEQTYPE) != 0)
+{
+#ifndef NO_ERROR_CHECKING
+  if (r.get_type() & AA_SEQTYPE)
+    throw std::runtime_error("Cannot enumerate amino acid record");
+#endif
+}
+
+iupac_enumerator& iupac_enumerator::operator++()
+{
+  size_t i = _pos.size();
+  while (i > 0)
+  {
+    i--;
+    unsigned char d = _digit[i] + 1 == _nchoices[i] ? 0 : _digit[i] + 1;
+    char old = _seq[_pos[i]];
+    _digit[i] = d;
+    _seq[_pos[i]] = _choices[i][d];
+    if (_seq.size() <= 32)
+    {
+      unsigned shift = 2 * (_seq.size() - 1 - _pos[i]);
+      uint64_t diff = GData::twobit[static_cast<unsigned char>(old)] ^
+        GData::twobit[static_cast<unsigned char>(_seq[_pos[i]])];
+      _kmer ^= diff << shift;
+    }
+    if (d != 0)
+      return *this;
+  }
+  _end = true;
+  return *this;
+}
+
+uint64_t iupac_enumerator::kmer(void) const
+{
+#ifndef NO_ERROR_CHECKING
+  if (_seq.size() > 32)
+    throw std::runtime_error("Only sequences of up to 32 bases can be "
+                             "encoded as k-mers");
+#endif
+  return _kmer;
+}
+
+std::string iupac_enumerator::suffix(void) const
+{
+  std::string ret;
+  for (size_t i = 0; i < _pos.size(); i++)
+  {
+    ret += '_';
+    ret += std::to_string(_pos[i] + 1);
+    ret += _seq[_pos[i]];
+  }
+  return ret;
+}
+
+uint64_t iupac_enumerator::count(const char * seq, length_t len)
+{
+  uint64_t ret = 1;
+  for (length_t i = 0; i < len; i++)
+  {
+    unsigned char m = GData::iupac_mask[static_cast<unsigned char>(seq[i])];
+    if (m == 0)
+      invalid_char(seq[i]);
+    uint64_t n = popcount4(m);
+    if (ret > UINT64_MAX / n)
+      return UINT64_MAX;
+    ret *= n;
+  }
+  return ret;
+}
+
+}
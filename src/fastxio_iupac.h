@@ -0,0 +1,100 @@
+#ifndef _FASTX_IO_IUPAC_H_
+#define _FASTX_IO_IUPAC_H_
+
+#include <string>
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <fastxio_common.h>
+#include <fastxio_record.h>
+
+namespace FASTX {
+
+/**
+ * @brief Lazy enumeration of all sequences an ambiguous IUPAC sequence
+ * stands for
+ *
+ * The enumerator works like an odometer: the ambiguous positions are the
+ * digits, the last one turning fastest. Each step changes the current
+ * sequence in place, so memory use is independent of the number of
+ * expansions. The case of the input is kept.
+ */
+class iupac_enumerator
+{
+public:
+  /**
+   * @brief Constructor on a raw sequence
+   *
+   * @param seq Pointer to the sequence
+   * @param len Length of the sequence
+   * @param rna Expand to U instead of T
+   */
+  iupac_enumerator(const char * seq, length_t len, bool rna = false);
+
+  /**
+   * @brief Constructor on a DNA or RNA record
+   *
+   * @param r A `Record` object
+   */
+  explicit iupac_enumerator(const Record& r);
+
+  /**
+   * @brief Move to the next expansion
+   */
+  iupac_enumerator& operator++();
+
+  /**
+   * @brief Check if all expansions have been visited
+   */
+  bool end(void) const { return _end; }
+
+  /**
+   * @brief The current expansion
+   */
+  const std::string& operator*() const { return _seq; }
+
+  /**
+   * @brief The current expansion as a 2-bit encoded k-mer (see
+   * `kmer_iterator`), only available for sequences of up to 32 bases
+   */
+  uint64_t kmer(void) const;
+
+  /**
+   * @brief Positions and bases chosen for the ambiguous characters
+   *
+   * @return "_<position><base>" for every ambiguous position, positions
+   * are 1-offset
+   */
+  std::string suffix(void) const;
+
+  /**
+   * @brief Number of ambiguous positions
+   */
+  size_t ambiguous(void) const { return _pos.size(); }
+
+  /**
+   * @brief Number of expansions of a sequence, without enumerating them
+   *
+   * @param seq Pointer to the sequence
+   * @param len Length of the sequence
+   * @return The number of expansions, UINT64_MAX if it does not fit
+   */
+  static uint64_t count(const char * seq, length_t len);
+
+private:
+  std::string _seq;
+  std::vector<length_t> _pos;                // Ambiguous positions
+  std::vector<std::array<char, 4>> _choices; // Bases of each position
+  std::vector<unsigned char> _nchoices;
+  std::vector<unsigned char> _digit;         // Current choice
+  uint64_t _kmer;
+  bool _end;
+
+  /**
+   * Examples
+   *  @example enumerate_iupac.cpp
+   */
+};
+
+}
+#endif
@@ -0,0 +1,40 @@
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <fastxio_common.h>
+#include <fastxio_record.h>
+#include <fastxio_kmer.h>
+
+namespace FASTX {
+
+PackedSequence::PackedSequence(const char * seq, length_t len) :
+  _bases((len + 31) / 32, 0), _invalid((len + 63) / 64, 0), _size(len)
+{
+  for (length_t i = 0; i < len; i++)
+  {
+    unsigned char c = GData::twobit[static_cast<unsigned char>(seq[i])];
+    if (c > 3)
+      _invalid[i >> 6] |= uint64_t(1) << (i & 63);
+    else
+      _bases[i >> 5] |= uint64_t(c) << (2 * (i & 31));
+  }
+}
+
+PackedSequence::PackedSequence(const Record& r) :
+  PackedSequence(r.get_seq().data(), r.size())
+{
+}
+
+std::string PackedSequence::unpack(void) const
+{
+  std::string ret(_size, 'N');
+  for (length_t i = 0; i < _size; i++)
+  {
+    unsigned char c = code(i);
+    if (c < 4)
+      ret[i] = "ACGT"[c];
+  }
+  return ret;
+}
+
+}
@@ -0,0 +1,254 @@
+#ifndef _FASTX_IO_KMER_H_
+#define _FASTX_IO_KMER_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <fastxio_common.h>
+#include <fastxio_record.h>
+
+namespace FASTX {
+
+/**
+ * @brief A nucleotide sequence packed into 2 bits per base
+ *
+ * Bases other than A, C, G and T/U are flagged in a separate bit vector
+ * and unpacked as N. A packed sequence takes about a quarter of the
+ * memory of a `Record`, and k-mers can be iterated directly from it.
+ */
+class PackedSequence
+{
+public:
+  /**
+   * @brief Empty constructor
+   */
+  PackedSequence(void) : _size(0) {}
+
+  /**
+   * @brief Pack a raw sequence
+   *
+   * @param seq Pointer to the sequence
+   * @param len Length of the sequence
+   */
+  PackedSequence(const char * seq, length_t len);
+
+  /**
+   * @brief Pack the sequence of a record
+   *
+   * @param r A `Record` object
+   */
+  explicit PackedSequence(const Record& r);
+
+  /**
+   * @brief Number of bases
+   */
+  length_t size(void) const { return _size; }
+
+  /**
+   * @brief 2-bit code of a base
+   *
+   * @param i The (0-offset) position
+   * @return A = 0, C = 1, G = 2, T = 3 or 4 for all other characters
+   */
+  unsigned char code(length_t i) const {
+    if ((_invalid[i >> 6] >> (i & 63)) & 1)
+      return 4;
+    return (_bases[i >> 5] >> (2 * (i & 31))) & 3;
+  }
+
+  /**
+   * @brief Unpack the sequence
+   *
+   * @return The sequence in uppercase, with N for all non-ACGT bases
+   */
+  std::string unpack(void) const;
+
+private:
+  std::vector<uint64_t> _bases;   // 32 bases per word, first base lowest
+  std::vector<uint64_t> _invalid; // 1 bit per base
+  length_t _size;
+};
+
+/**
+ * @brief Rolling iterator over the 2-bit encoded k-mers of a sequence
+ *
+ * Every k-mer is packed into an integer of type `T`, two bits per base
+ * (A = 0, C = 1, G = 2, T/U = 3) with the first base in the highest bits.
+ * The forward and the reverse complement k-mer are updated in O(1) per
+ * base. K-mers that contain anything but A, C, G or T/U (e.g. N or other
+ * IUPAC codes) are skipped.
+ *
+ * The iterator reads either raw characters or a `PackedSequence` and only
+ * keeps a pointer to the sequence, which has to outlive it. Use
+ * `kmer_iterator` (k <= 32) or `kmer_iterator128` (k <= 64, if the
+ * compiler supports 128-bit integers).
+ */
+template <typename T>
+class basic_kmer_iterator
+{
+public:
+  /**
+   * @brief Largest k-mer size that fits into T
+   */
+  static const unsigned short max_k = sizeof(T) * 4;
+
+  /**
+   * @brief Constructor on a raw sequence
+   *
+   * @param k The k-mer size
+   * @param seq Pointer to the sequence
+   * @param len Length of the sequence
+   */
+  basic_kmer_iterator(unsigned short k, const char * seq, length_t len) :
+    _seq(seq), _packed(nullptr), _len(len) {
+    init(k);
+  }
+
+  /**
+   * @brief Constructor on a record
+   *
+   * @param k The k-mer size
+   * @param r A `Record` object, which has to outlive the iterator
+   */
+  basic_kmer_iterator(unsigned short k, const Record& r) :
+    basic_kmer_iterator(k, r.get_seq().data(), r.size()) {}
+
+  /**
+   * @brief Constructor on a packed sequence
+   *
+   * @param k The k-mer size
+   * @param p A `PackedSequence` object, which has to outlive the iterator
+   */
+  basic_kmer_iterator(unsigned short k, const PackedSequence& p) :
+    _seq(nullptr), _packed(&p), _len(p.size()) {
+    init(k);
+  }
+
+  /**
+   * @brief Move to the next valid k-mer
+   */
+  basic_kmer_iterator& operator++() {
+    advance();
+    return *this;
+  }
+
+  /**
+   * @brief Check if all k-mers have been visited
+   *
+   * @return True if there is no current k-mer
+   */
+  bool end() const { return _end; }
+
+  /**
+   * @brief The current k-mer
+   */
+  T operator*() const { return _fwd; }
+
+  /**
+   * @brief The current k-mer
+   */
+  T forward() const { return _fwd; }
+
+  /**
+   * @brief The reverse complement of the current k-mer
+   */
+  T reverse() const { return _rev; }
+
+  /**
+   * @brief The smaller of the current k-mer and its reverse complement
+   */
+  T canonical() const { return _fwd < _rev ? _fwd : _rev; }
+
+  /**
+   * @brief The (0-offset) start position of the current k-mer
+   */
+  length_t position() const { return _next - _k; }
+
+  /**
+   * @brief The k-mer size
+   */
+  unsigned short k() const { return _k; }
+
+private:
+  void init(unsigned short k) {
+#ifndef NO_ERROR_CHECKING
+    if (k == 0 || k > max_k)
+      throw std::runtime_error("K-mer size must be between 1 and " +
+                               std::to_string(max_k));
+#endif
+    _next = 0;
+    _valid = 0;
+    _k = k;
+    _shift = 2 * (k - 1);
+    _mask = k == max_k ? ~T(0) : (T(1) << (2 * k)) - 1;
+    _fwd = 0;
+    _rev = 0;
+    _end = false;
+    advance();
+  }
+
+  void advance() {
+    while (_next < _len)
+    {
+      unsigned char c = _packed ? _packed->code(_next++) :
+        GData::twobit[static_cast<unsigned char>(_seq[_next++])];
+      if (c > 3)
+      {
+        _valid = 0;
+        continue;
+      }
+      _fwd = ((_fwd << 2) | c) & _mask;
+      _rev = (_rev >> 2) | (T(3 - c) << _shift);
+      if (++_valid >= _k)
+        return;
+    }
+    _end = true;
+  }
+
+  const char * _seq;
+  const PackedSequence * _packed;
+  length_t _len;
+  length_t _next;  // Next base to read
+  length_t _valid; // Valid bases since the last skipped one
+  unsigned short _k;
+  unsigned short _shift;
+  T _mask;
+  T _fwd;
+  T _rev;
+  bool _end;
+};
+
+/**
+ * @brief K-mer iterator for k <= 32
+ */
+typedef basic_kmer_iterator<uint64_t> kmer_iterator;
+
+#ifdef __SIZEOF_INT128__
+/**
+ * @brief K-mer iterator for k <= 64
+ */
+typedef basic_kmer_iterator<unsigned __int128> kmer_iterator128;
+#endif
+
+/**
+ * @brief Decode a 2-bit encoded k-mer
+ *
+ * @param kmer The encoded k-mer
+ * @param k The k-mer size
+ * @return The k-mer as a string of A, C, G and T
+ */
+template <typename T>
+std::string decode_kmer(T kmer, unsigned short k)
+{
+  std::string ret(k, 'A');
+  for (unsigned short i = k; i > 0; i--)
+  {
+    ret[i - 1] = "ACGT"[static_cast<unsigned>(kmer & 3)];
+    kmer >>= 2;
+  }
+  return ret;
+}
+
+}
+#endif
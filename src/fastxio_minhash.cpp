@@ -1,9 +1,23 @@
 #include <fastxio_minhash.h>
 #include <fastxio_record.h>
+#include <fastxio_nthash.h>
 #include <MurmurHash3.h>
 #include <cstdint>
 #include <vector>
-#include <unordered_set>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define FASTX_MINHASH_MMAP
+#endif
 
 #define SEED 314159265
 
@@ -11,88 +25,586 @@ namespace FASTX {
 
 extern GData global;
 
-uint32_t set_isec(std::unordered_set<uint32_t>& lhs,
-                  std::unordered_set<uint32_t>& rhs)
+uint32_t set_isec(const uint32_t * lhs, size_t lhs_size,
+                  const uint32_t * rhs, size_t rhs_size)
 {
   uint32_t hits = 0;
-  for (auto& item : lhs)
+  size_t i = 0;
+  size_t j = 0;
+  while (i < lhs_size && j < rhs_size)
   {
-    if (rhs.find(item) != rhs.end())
-      hits++;
+    uint32_t a = lhs[i];
+    uint32_t b = rhs[j];
+    hits += a == b;
+    i += a <= b;
+    j += b <= a;
   }
   return hits;
 }
 
-MinHash::MinHash(uint32_t j, uint32_t k) : _j(j), _k(k)
-{}
+MinHash::MinHash(uint32_t j, uint32_t k, bool canonical, uint32_t scale) :
+  _j(j), _k(k), _canonical(canonical), _scale(scale), _offsets(1, 0),
+  _id_offsets(1, 0),
+  _dirty(true), _mapped()
+{
+#ifndef NO_ERROR_CHECKING
+  if (k == 0)
+    throw std::runtime_error("K-mer size must be at least 1");
+#endif
+}
 
-void MinHash::add(const Record& rec, bool complement)
+namespace {
+
+// Layout of a saved index. The arrays follow the header in this order,
+// 64-bit arrays first, so every array is naturally aligned:
+// offsets, id_offsets (n_sketches + 1 each), index_offsets
+// (n_index_hashes + 1), sketches, index_hashes, index_refs, id_chars
+struct db_header_t
 {
-  std::vector<uint32_t> hashes;
-  hashes.reserve(rec.size() - _k + 1);
-  int _ki = _k;
-  for (uint64_t i = 0; i < (rec.size() - _k); i++)
+  char magic[8];
+  uint32_t version;
+  uint32_t j;
+  uint32_t k;
+  uint32_t flags;
+  uint32_t seed;
+  uint32_t scale;
+  uint64_t n_sketches;
+  uint64_t n_hashes;
+  uint64_t n_id_chars;
+  uint64_t n_index_hashes;
+  uint64_t n_index_refs;
+};
+static_assert(sizeof(db_header_t) == 72, "Unexpected MinHash header size");
+
+const char DB_MAGIC[8] = {'F', 'X', 'M', 'H', 'A', 'S', 'H', '\0'};
+// Version 1 had no scale, the field was zero
+const uint32_t DB_VERSION = 2;
+const uint32_t DB_CANONICAL = 1;
+
+// Check that the arrays of a header fit into a file of the given size.
+// Every count is bounded first, so the sum cannot overflow.
+bool db_fits(const db_header_t& h, uint64_t size)
+{
+  const uint64_t max_count = size / 4;
+  if (h.n_sketches > std::numeric_limits<uint32_t>::max() ||
+      h.n_sketches > max_count || h.n_hashes > max_count ||
+      h.n_index_hashes > max_count || h.n_index_refs > max_count ||
+      h.n_id_chars > size)
+    return false;
+  return size >= sizeof(db_header_t) +
+    8 * (2 * (h.n_sketches + 1) + h.n_index_hashes + 1) +
+    4 * (h.n_hashes + h.n_index_hashes + h.n_index_refs) + h.n_id_chars;
+}
+
+// Check that an array never decreases, or strictly increases
+template <typename T>
+bool is_sorted(const T * data, uint64_t n, bool strict)
+{
+  for (uint64_t i = 1; i < n; i++)
+  {
+    if (data[i] < data[i - 1] || (strict && data[i] == data[i - 1]))
+      return false;
+  }
+  return true;
+}
+
+template <typename T>
+void write_array(std::ostream& out, const T * data, uint64_t n)
+{
+  out.write(reinterpret_cast<const char *>(data), n * sizeof(T));
+}
+
+// Keep the j smallest distinct values
+void compact(std::vector<uint32_t>& buf, uint32_t j)
+{
+  std::sort(buf.begin(), buf.end());
+  buf.erase(std::unique(buf.begin(), buf.end()), buf.end());
+  if (buf.size() > j)
+    buf.resize(j);
+}
+
+// Bottom-j selection on a buffer of at most 2j hashes. Once j distinct
+// hashes are known, larger ones are dropped as they arrive, so the
+// buffer is compacted O(n / j) times at most.
+class bottom_j
+{
+public:
+  bottom_j(std::vector<uint32_t>& buf, uint32_t j) :
+    _buf(buf), _j(j), _cap(2 * static_cast<size_t>(j)),
+    _threshold(std::numeric_limits<uint32_t>::max())
+  {
+    _buf.clear();
+    _buf.reserve(_cap);
+  }
+
+  void push(uint32_t h)
+  {
+    if (h > _threshold)
+      return;
+    _buf.push_back(h);
+    if (_buf.size() == _cap)
+    {
+      compact(_buf, _j);
+      if (_buf.size() == _j)
+        _threshold = _buf.back();
+    }
+  }
+
+  void finish(void) { compact(_buf, _j); }
+
+private:
+  std::vector<uint32_t>& _buf;
+  uint32_t _j;
+  size_t _cap;
+  uint32_t _threshold;
+};
+
+// FracMinHash selection: all distinct hashes up to a fixed maximum, so the
+// sketch size grows with the sequence
+class below_max
+{
+public:
+  below_max(std::vector<uint32_t>& buf, uint32_t max_hash) :
+    _buf(buf), _max_hash(max_hash)
   {
-    uint32_t hash[4]; // We get 128 bits from MurmurHash3_x64_128
-    MurmurHash3_x64_128(&rec._seq[i], _ki, SEED, &hash);
-    hashes.push_back(hash[0]); // Keep only 32 bits
+    _buf.clear();
   }
-  std::sort(hashes.begin(), hashes.end());
-  std::unordered_set<uint32_t> hashset;
-  for (auto& h : hashes)
+
+  void push(uint32_t h)
+  {
+    if (h <= _max_hash)
+      _buf.push_back(h);
+  }
+
+  void finish(void)
   {
-    hashset.insert(h);
-    if (hashset.size() == _j) break;
+    std::sort(_buf.begin(), _buf.end());
+    _buf.erase(std::unique(_buf.begin(), _buf.end()), _buf.end());
   }
-  _hashes.push_back(hashset);
-  _ids.push_back(rec._id);
-  if (complement)
+
+private:
+  std::vector<uint32_t>& _buf;
+  uint32_t _max_hash;
+};
+
+} // anonymous namespace
+
+void MinHash::make_sketch(const Record& rec, std::vector<uint32_t>& out) const
+{
+  out.clear();
+  if (_scale > 0)
+  {
+    below_max sel(out, std::numeric_limits<uint32_t>::max() / _scale);
+    hash_kmers(rec, sel);
+  }
+  else if (_j > 0)
+  {
+    bottom_j sel(out, _j);
+    hash_kmers(rec, sel);
+  }
+}
+
+template <typename Selector>
+void MinHash::hash_kmers(const Record& rec, Selector& sel) const
+{
+  if (_canonical)
+  {
+    // Strand independent ntHash, k-mers with N are skipped
+    for (nthash_iterator it(_k, rec._seq.data(), rec.size()); ! it.end(); ++it)
+      sel.push(static_cast<uint32_t>(it.canonical() >> 32));
+  }
+  else
+  {
+    int _ki = _k;
+    for (uint64_t i = 0; i + _k <= rec.size(); i++)
+    {
+      uint32_t hash[4]; // We get 128 bits from MurmurHash3_x64_128
+      MurmurHash3_x64_128(&rec._seq[i], _ki, SEED, &hash);
+      sel.push(hash[0]); // Keep only 32 bits
+    }
+  }
+  sel.finish();
+}
+
+MinHash::arrays_t MinHash::arrays(void) const
+{
+  if (_file)
+    return _mapped;
+  arrays_t a;
+  a.sketches = _sketches.data();
+  a.offsets = _offsets.data();
+  a.id_offsets = _id_offsets.data();
+  a.id_chars = _id_chars.data();
+  a.index_hashes = _index_hashes.data();
+  a.index_offsets = _index_offsets.data();
+  a.index_refs = _index_refs.data();
+  a.n_sketches = _offsets.size() - 1;
+  a.n_index_hashes = _index_hashes.size();
+  return a;
+}
+
+size_t MinHash::size(void) const
+{
+  return _file ? _mapped.n_sketches : _offsets.size() - 1;
+}
+
+const uint32_t * MinHash::sketch(uint32_t idx) const
+{
+  arrays_t a = arrays();
+  return a.sketches + a.offsets[idx];
+}
+
+uint32_t MinHash::sketch_size(uint32_t idx) const
+{
+  arrays_t a = arrays();
+  return a.offsets[idx + 1] - a.offsets[idx];
+}
+
+std::string MinHash::id(uint32_t idx) const
+{
+  arrays_t a = arrays();
+  return std::string(a.id_chars + a.id_offsets[idx],
+                     a.id_offsets[idx + 1] - a.id_offsets[idx]);
+}
+
+void MinHash::add(const Record& rec, bool complement)
+{
+#ifndef NO_ERROR_CHECKING
+  if (_file)
+    throw std::runtime_error("Cannot add to a MinHash index opened from a "
+                             "file");
+#endif
+  std::vector<uint32_t> hashes;
+  make_sketch(rec, hashes);
+  _sketches.insert(_sketches.end(), hashes.begin(), hashes.end());
+  _offsets.push_back(_sketches.size());
+  _id_chars.insert(_id_chars.end(), rec._id.begin(), rec._id.end());
+  _id_offsets.push_back(_id_chars.size());
+  _dirty = true;
+  if (complement && ! _canonical)
   {
     Record tmp = !rec;
     this->add(tmp, false);
   }
 }
 
-minhash_sim_t MinHash::max_similarity(const Record& rec)
+void MinHash::build_index(void)
 {
-  std::vector<uint32_t> hashes;
-  hashes.reserve(rec.size() - _k + 1);
-  for (uint64_t i = 0; i < (rec.size() - _k); ++i)
+  // A mapped index is complete
+  if (_file)
+    return;
+
+  // (hash, sketch) pairs, sorted by hash and then by sketch
+  std::vector<uint64_t> pairs;
+  pairs.reserve(_sketches.size());
+  for (uint32_t idx = 0; idx < size(); idx++)
   {
-    uint32_t hash[4]; // We get 128 bits from MurmurHash3_x64_128
-    MurmurHash3_x64_128(&rec._seq[i], _k, SEED, &hash);
-    hashes.push_back(hash[0]); // Keep only 32 bits
+    for (uint64_t i = _offsets[idx]; i < _offsets[idx + 1]; i++)
+      pairs.push_back((static_cast<uint64_t>(_sketches[i]) << 32) | idx);
   }
-  std::sort(hashes.begin(), hashes.end());
-  std::unordered_set<uint32_t> hashset;
-  for (auto& h : hashes)
+  std::sort(pairs.begin(), pairs.end());
+
+  _index_hashes.clear();
+  _index_offsets.clear();
+  _index_refs.clear();
+  _index_refs.reserve(pairs.size());
+  for (uint64_t p : pairs)
   {
-    hashset.insert(h);
-    if (hashset.size() == _j) break;
+    uint32_t hash = p >> 32;
+    if (_index_hashes.empty() || _index_hashes.back() != hash)
+    {
+      _index_hashes.push_back(hash);
+      _index_offsets.push_back(_index_refs.size());
+    }
+    _index_refs.push_back(static_cast<uint32_t>(p));
   }
+  _index_offsets.push_back(_index_refs.size());
+  _dirty = false;
+}
+
+void MinHash::save(const std::string& path)
+{
+  if (_dirty)
+    build_index();
+  arrays_t a = arrays();
 
+  db_header_t h;
+  std::memset(&h, 0, sizeof(h));
+  std::memcpy(h.magic, DB_MAGIC, sizeof(DB_MAGIC));
+  h.version = DB_VERSION;
+  h.j = _j;
+  h.k = _k;
+  h.flags = _canonical ? DB_CANONICAL : 0;
+  h.seed = SEED;
+  h.scale = _scale;
+  h.n_sketches = a.n_sketches;
+  h.n_hashes = a.offsets[a.n_sketches];
+  h.n_id_chars = a.id_offsets[a.n_sketches];
+  h.n_index_hashes = a.n_index_hashes;
+  h.n_index_refs = a.index_offsets[a.n_index_hashes];
+
+  // Written next to the target and renamed, so an index opened from the
+  // same path stays intact while it is read
+  const std::string tmp = path + ".tmp";
+  std::ofstream out(tmp.c_str(), std::ios::out | std::ios::binary);
+#ifndef NO_ERROR_CHECKING
+  if (! out)
+    throw std::runtime_error("Could not open file: " + tmp);
+#endif
+  out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+  write_array(out, a.offsets, h.n_sketches + 1);
+  write_array(out, a.id_offsets, h.n_sketches + 1);
+  write_array(out, a.index_offsets, h.n_index_hashes + 1);
+  write_array(out, a.sketches, h.n_hashes);
+  write_array(out, a.index_hashes, h.n_index_hashes);
+  write_array(out, a.index_refs, h.n_index_refs);
+  write_array(out, a.id_chars, h.n_id_chars);
+  out.close();
+#ifndef NO_ERROR_CHECKING
+  if (! out)
+  {
+    std::remove(tmp.c_str());
+    throw std::runtime_error("Could not write file: " + tmp);
+  }
+#endif
+  if (std::rename(tmp.c_str(), path.c_str()) != 0)
+  {
+    std::remove(tmp.c_str());
+#ifndef NO_ERROR_CHECKING
+    throw std::runtime_error("Could not rename " + tmp + " to " + path);
+#endif
+  }
+}
+
+MinHash MinHash::open(const std::string& path)
+{
+  std::shared_ptr<const char> file;
+  uint64_t size = 0;
+#ifdef FASTX_MINHASH_MMAP
+  int fd = ::open(path.c_str(), O_RDONLY);
+#ifndef NO_ERROR_CHECKING
+  if (fd < 0)
+    throw std::runtime_error("Could not open file: " + path);
+#endif
+  struct stat st;
+  if (fstat(fd, &st) == 0)
+    size = st.st_size;
+  void * addr = size ? mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) :
+    MAP_FAILED;
+  close(fd);
+#ifndef NO_ERROR_CHECKING
+  if (addr == MAP_FAILED)
+    throw std::runtime_error("Could not map file: " + path);
+#endif
+  file = std::shared_ptr<const char>(static_cast<const char *>(addr),
+                                     [size](const char * p)
+                                     {
+                                       munmap(const_cast<char *>(p), size);
+                                     });
+#else
+  // Without mmap the file is read into memory
+  std::ifstream in(path.c_str(), std::ios::in | std::ios::binary);
+#ifndef NO_ERROR_CHECKING
+  if (! in)
+    throw std::runtime_error("Could not open file: " + path);
+#endif
+  in.seekg(0, std::ios::end);
+  std::streamoff end = in.tellg();
+#ifndef NO_ERROR_CHECKING
+  if (end < 0)
+    throw std::runtime_error("Could not read file: " + path);
+#endif
+  size = end;
+  in.seekg(0, std::ios::beg);
+  char * buf = new char[size];
+  file = std::shared_ptr<const char>(buf, std::default_delete<char[]>());
+  in.read(buf, size);
+#ifndef NO_ERROR_CHECKING
+  if (static_cast<uint64_t>(in.gcount()) != size)
+    throw std::runtime_error("Could not read file: " + path);
+#endif
+#endif
+
+  db_header_t h;
+#ifndef NO_ERROR_CHECKING
+  if (size < sizeof(h))
+    throw std::runtime_error("Not a MinHash index: " + path);
+#endif
+  std::memcpy(&h, file.get(), sizeof(h));
+#ifndef NO_ERROR_CHECKING
+  if (std::memcmp(h.magic, DB_MAGIC, sizeof(DB_MAGIC)) != 0)
+    throw std::runtime_error("Not a MinHash index: " + path);
+  if (h.version == 0 || h.version > DB_VERSION)
+    throw std::runtime_error("Unsupported MinHash index version " +
+                             std::to_string(h.version) + ": " + path);
+  if (h.seed != SEED || ! db_fits(h, size))
+    throw std::runtime_error("Corrupt MinHash index: " + path);
+#endif
+
+  MinHash ret(h.j, h.k, (h.flags & DB_CANONICAL) != 0, h.scale);
+  const char * p = file.get() + sizeof(h);
+  arrays_t& a = ret._mapped;
+  a.n_sketches = h.n_sketches;
+  a.n_index_hashes = h.n_index_hashes;
+  a.offsets = reinterpret_cast<const uint64_t *>(p);
+  p += 8 * (h.n_sketches + 1);
+  a.id_offsets = reinterpret_cast<const uint64_t *>(p);
+  p += 8 * (h.n_sketches + 1);
+  a.index_offsets = reinterpret_cast<const uint64_t *>(p);
+  p += 8 * (h.n_index_hashes + 1);
+  a.sketches = reinterpret_cast<const uint32_t *>(p);
+  p += 4 * h.n_hashes;
+  a.index_hashes = reinterpret_cast<const uint32_t *>(p);
+  p += 4 * h.n_index_hashes;
+  a.index_refs = reinterpret_cast<const uint32_t *>(p);
+  p += 4 * h.n_index_refs;
+  a.id_chars = p;
+#ifndef NO_ERROR_CHECKING
+  // The offsets open and close the arrays
+  if (a.offsets[0] != 0 || a.id_offsets[0] != 0 || a.index_offsets[0] != 0 ||
+      a.offsets[h.n_sketches] != h.n_hashes ||
+      a.id_offsets[h.n_sketches] != h.n_id_chars ||
+      a.index_offsets[h.n_index_hashes] != h.n_index_refs)
+    throw std::runtime_error("Corrupt MinHash index: " + path);
+  // Queries rely on the order of the arrays and index the sketches by
+  // reference
+  bool valid = is_sorted(a.offsets, h.n_sketches + 1, false) &&
+    is_sorted(a.id_offsets, h.n_sketches + 1, false) &&
+    is_sorted(a.index_offsets, h.n_index_hashes + 1, false) &&
+    is_sorted(a.index_hashes, h.n_index_hashes, true);
+  for (uint64_t r = 0; valid && r < h.n_index_refs; r++)
+    valid = a.index_refs[r] < h.n_sketches;
+  if (! valid)
+    throw std::runtime_error("Corrupt MinHash index: " + path);
+#endif
+  ret._file = file;
+  ret._dirty = false;
+  return ret;
+}
+
+minhash_sim_t MinHash::compare(const std::vector<uint32_t>& query,
+                               uint32_t idx, uint32_t hits) const
+{
   minhash_sim_t res;
+  res.asize = query.size();
+  res.bsize = sketch_size(idx);
+  res.hits = hits;
+  res.idx = idx;
+  double hitsd = hits;
+  // Two empty sketches, e.g. scaled sketches of short reads, share nothing
+  res.ji = res.asize + res.bsize ? hitsd / (res.asize + res.bsize - hitsd) : 0;
+  res.a_in_b = res.asize ? hitsd / res.asize : 0;
+  res.b_in_a = res.bsize ? hitsd / res.bsize : 0;
+  return res;
+}
 
-  res.ji = -std::numeric_limits<double>::infinity();
-  uint32_t ctr = 0;
-  for (auto& comp : _hashes)
-  {
-    uint32_t hits = set_isec(hashset, comp);
-    double hitsd = hits;
-    double asize = hashset.size();
-    double bsize = comp.size();
-    double sim = hitsd / (asize + bsize - hitsd);
-    if (sim > res.ji)
+void MinHash::count_hits(const std::vector<uint32_t>& query,
+                         std::vector<minhash_sim_t>& hits) const
+{
+  hits.clear();
+  if (_dirty)
+  {
+    for (uint32_t idx = 0; idx < size(); idx++)
     {
-      res.asize = hashset.size();
-      res.hits = hits;
-      res.bsize = comp.size();
-      res.ji = sim;
-      res.idx = ctr;
+      uint32_t h = set_isec(query.data(), query.size(), sketch(idx),
+                            sketch_size(idx));
+      if (h > 0)
+        hits.push_back(compare(query, idx, h));
     }
-    ctr++;
+    return;
+  }
+
+  // Scratch counters of a thread, only touched entries are reset
+  static thread_local std::vector<uint32_t> counts;
+  static thread_local std::vector<uint32_t> touched;
+  if (counts.size() < size())
+    counts.resize(size(), 0);
+  touched.clear();
+
+  // The query is sorted, so each lookup starts after the previous one
+  arrays_t a = arrays();
+  const uint32_t * first = a.index_hashes;
+  const uint32_t * last = a.index_hashes + a.n_index_hashes;
+  for (uint32_t h : query)
+  {
+    first = std::lower_bound(first, last, h);
+    if (first == last)
+      break;
+    if (*first != h)
+      continue;
+    size_t i = first - a.index_hashes;
+    for (uint64_t r = a.index_offsets[i]; r < a.index_offsets[i + 1]; r++)
+    {
+      uint32_t idx = a.index_refs[r];
+      if (counts[idx]++ == 0)
+        touched.push_back(idx);
+    }
+  }
+  std::sort(touched.begin(), touched.end());
+  for (uint32_t idx : touched)
+  {
+    hits.push_back(compare(query, idx, counts[idx]));
+    counts[idx] = 0;
+  }
+}
+
+namespace {
+
+// Hit ranking: by Jaccard index, or by containment of the query with the
+// Jaccard index breaking ties, then by sketch
+bool better(const minhash_sim_t& a, const minhash_sim_t& b, bool containment)
+{
+  if (containment && a.a_in_b != b.a_in_b)
+    return a.a_in_b > b.a_in_b;
+  return a.ji != b.ji ? a.ji > b.ji : a.idx < b.idx;
+}
+
+} // anonymous namespace
+
+minhash_sim_t MinHash::max_similarity(const Record& rec,
+                                      bool containment) const
+{
+  // Reused by every query of a thread
+  static thread_local std::vector<uint32_t> hashes;
+  static thread_local std::vector<minhash_sim_t> hits;
+  make_sketch(rec, hashes);
+  count_hits(hashes, hits);
+
+  minhash_sim_t res;
+  res.ji = -std::numeric_limits<double>::infinity();
+  // Without any shared hash, all sketches are equally (dis)similar
+  if (hits.empty() && size() > 0)
+    res = compare(hashes, 0, 0);
+  for (const minhash_sim_t& h : hits)
+  {
+    if (better(h, res, containment))
+      res = h;
   }
   return res;
 }
 
-}
\ No newline at end of file
+std::vector<minhash_sim_t> MinHash::top_similarity(const Record& rec,
+                                                   size_t n,
+                                                   bool containment) const
+{
+  static thread_local std::vector<uint32_t> hashes;
+  std::vector<minhash_sim_t> hits;
+  make_sketch(rec, hashes);
+  count_hits(hashes, hits);
+  auto order = [containment](const minhash_sim_t& a, const minhash_sim_t& b)
+  {
+    return better(a, b, containment);
+  };
+  if (hits.size() > n)
+  {
+    std::partial_sort(hits.begin(), hits.begin() + n, hits.end(), order);
+    hits.resize(n);
+  }
+  else
+  {
+    std::sort(hits.begin(), hits.end(), order);
+  }
+  return hits;
+}
+
+}
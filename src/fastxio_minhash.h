@@ -3,35 +3,70 @@
 
 #include <fastxio_record.h>
 #include <cstdint>
-#include <unordered_set>
+#include <vector>
+#include <string>
+#include <memory>
 
 namespace FASTX {
 
+/**
+ * @brief Similarity of a query (a) to an index sketch (b)
+ */
 struct minhash_sim_t
 {
+  // Jaccard index
   double ji = 0;
+  // Containment of a in b (hits / asize) and of b in a (hits / bsize)
+  double a_in_b = 0;
+  double b_in_a = 0;
+  // Shared hashes
   uint32_t hits = 0;
+  // Index of the sketch, see MinHash::id()
   uint32_t idx = 0;
+  // Sketch sizes
   uint32_t asize = 0;
   uint32_t bsize = 0;
 };
 
 /**
-   * @brief Compute the number of intersects of two unordered sets.
+   * @brief Compute the number of intersects of two sorted arrays.
+   *
+   * Both arrays must be sorted and free of duplicates. They are walked in
+   * a single merge pass that advances without data dependent branches.
    *
-   * @param lhs First set
-   * @param rhs Second set
-   * @return The number of items shared between the two sets.
+   * @param lhs First array
+   * @param lhs_size Number of values in the first array
+   * @param rhs Second array
+   * @param rhs_size Number of values in the second array
+   * @return The number of items shared between the two arrays.
    */
-uint32_t set_isec(std::unordered_set<uint32_t>& lhs,
-                  std::unordered_set<uint32_t>& rhs);
+uint32_t set_isec(const uint32_t * lhs, size_t lhs_size,
+                  const uint32_t * rhs, size_t rhs_size);
 
 /**
    * @brief kmer overlap based on MinHash.
    *
    * This class will produce kmer overlaps using a locality sensitive
    * hashing approach (MinHash). Specifically, the implementation is
-   * the single hash function variant.
+   * the single hash function variant. All sketches are stored sorted and
+   * back to back in one flat array.
+   *
+   * Sketches keep the j smallest hashes of a sequence (bottom-k), or with a
+   * scale all hashes up to 2^32 / scale (FracMinHash). Scaled sketches grow
+   * with the sequence, so they are a fixed fraction of its k-mers and the
+   * containment of a short read in a long reference is estimated without
+   * bias, where its Jaccard index is tiny.
+   *
+   * Queries are answered from an inverted index (hash to sketches) once it
+   * was built with `build_index()`, so only sketches that share at least
+   * one hash with the query are compared. Until then, and after every
+   * `add()`, all sketches are scanned.
+   *
+   * An index can be written with `save()` and opened again with `open()`.
+   * Opened indices are memory mapped and used in place, so nothing is
+   * copied and processes on one machine share the pages. Opening validates
+   * the offsets and the inverted index in a single pass. Opened indices
+   * are read-only.
    */
 class MinHash {
 public:
@@ -41,17 +76,24 @@ public:
      *
      * @param j The number of hashes
      * @param k The sequence kmer size
+     * @param canonical `true` to hash k-mers strand independently with the
+     * canonical ntHash (see `nthash_iterator`), `false` for the forward
+     * MurmurHash3 of each k-mer, where `add()` indexes the reverse
+     * complement as a separate sketch.
+     * @param scale Keep all hashes up to 2^32 / scale instead of the j
+     * smallest, 0 for bottom-j sketches.
      *
      * @return A MinHash object with the given parameters.
      */
-  MinHash(uint32_t j, uint32_t k);
+  MinHash(uint32_t j, uint32_t k, bool canonical = true, uint32_t scale = 0);
   /**
      * @brief Add a `Record` object to the kmer index.
      *
      * @param r A `Record` object containing the sequence that is to be added to
      * the index.
      * @param complement `true` if the reverse complement of the sequence should
-     * also be added to the index.
+     * also be added to the index. Ignored for canonical hashes, which cover
+     * both strands with a single sketch.
      *
      */
   void add(const Record& r, bool complement = true);
@@ -60,12 +102,58 @@ public:
      * (best hit)
      *
      * @param r A new `Record` object.
+     * @param containment `true` to rank by the containment of the record in
+     * the sketches (`a_in_b`) instead of the Jaccard index.
+     *
+     * @return The similarity to the best hit, `idx` is meant to be used
+     * with `MinHash::id()`
+     */
+  minhash_sim_t max_similarity(const Record& r, bool containment = false) const;
+  /**
+     * @brief Get the most similar sketches of the index.
+     *
+     * @param r A new `Record` object.
+     * @param n The maximum number of hits to report
+     * @param containment `true` to rank by containment, see
+     * `max_similarity()`
+     *
+     * @return Up to n hits sharing at least one hash with the record, the
+     * most similar first.
+     */
+  std::vector<minhash_sim_t> top_similarity(const Record& r, size_t n,
+                                            bool containment = false) const;
+  /**
+     * @brief Build the inverted index.
+     *
+     * Must be called after the last `add()` and before querying from
+     * several threads.
+     */
+  void build_index(void);
+  /**
+     * @brief Check if queries use the inverted index.
+     *
+     * @return False if sketches were added after the last `build_index()`.
+     */
+  bool indexed(void) const {return ! _dirty;}
+  /**
+     * @brief Write the index to a file.
+     *
+     * The inverted index is built first if needed. The layout is
+     * versioned, integers are stored in the byte order of the machine.
+     * The file is written next to `path` and renamed into place, so an
+     * index opened from `path` can be saved back to it.
+     *
+     * @param path The output file
+     */
+  void save(const std::string& path);
+  /**
+     * @brief Open an index written by `save()`.
+     *
+     * @param path The index file
      *
-     * @return A pair of values. The first one is the match similarity, the
-     * second points to the index of id of the sequence that was the target.
-     * Meant to be used with `MinHash::id()`
+     * @return A read-only MinHash object using the mapped file.
      */
-  minhash_sim_t max_similarity(const Record& r);
+  static MinHash open(const std::string& path);
   /**
      * @brief Get the ID of an index sequence.
      *
@@ -73,15 +161,91 @@ public:
      *
      * @return The ID of the sequence that matches the index.
      */
-  std::string& id(uint32_t idx) {return _ids[idx];}
+  std::string id(uint32_t idx) const;
+  /**
+     * @brief Get the number of sketches in the index.
+     */
+  size_t size(void) const;
+  /**
+     * @brief Get a sketch of the index.
+     *
+     * @param idx The index of the sketch
+     *
+     * @return Pointer to the sorted hashes of the sketch, see `sketch_size()`
+     */
+  const uint32_t * sketch(uint32_t idx) const;
+  /**
+     * @brief Get the number of hashes of a sketch of the index.
+     */
+  uint32_t sketch_size(uint32_t idx) const;
+  /**
+     * @brief Get the number of hashes per sketch.
+     */
+  uint32_t j(void) const {return _j;}
+  /**
+     * @brief Get the kmer size.
+     */
+  uint32_t k(void) const {return _k;}
+  /**
+     * @brief Check if k-mers are hashed strand independently.
+     */
+  bool canonical(void) const {return _canonical;}
+  /**
+     * @brief Get the FracMinHash scale, 0 for bottom-j sketches.
+     */
+  uint32_t scale(void) const {return _scale;}
 private:
+  // The arrays of an index, either the members below or a mapped file
+  struct arrays_t
+  {
+    const uint32_t * sketches;
+    const uint64_t * offsets;
+    const uint64_t * id_offsets;
+    const char * id_chars;
+    const uint32_t * index_hashes;
+    const uint64_t * index_offsets;
+    const uint32_t * index_refs;
+    uint64_t n_sketches;
+    uint64_t n_index_hashes;
+  };
+  arrays_t arrays(void) const;
+
+  // Sorted, unique bottom-j hashes of a record
+  void make_sketch(const Record& r, std::vector<uint32_t>& out) const;
+  // Feed the k-mer hashes of a record to a selector
+  template <typename Selector>
+  void hash_kmers(const Record& r, Selector& sel) const;
+  // Similarity of a query sketch to sketch idx
+  minhash_sim_t compare(const std::vector<uint32_t>& query, uint32_t idx,
+                        uint32_t hits) const;
+  // Number of shared hashes with every sketch that shares any
+  void count_hits(const std::vector<uint32_t>& query,
+                  std::vector<minhash_sim_t>& hits) const;
+
   // Number of hashes
   const uint32_t _j;
   // Kmer length
   const uint32_t _k;
-  std::vector<std::unordered_set<uint32_t>> _hashes;
-  std::vector<std::string> _ids;
+  // Strand independent ntHash instead of MurmurHash3
+  const bool _canonical;
+  // Keep hashes up to 2^32 / _scale, 0 for the _j smallest
+  const uint32_t _scale;
+  // All sketches back to back, sketch i is [_offsets[i], _offsets[i + 1])
+  std::vector<uint32_t> _sketches;
+  std::vector<uint64_t> _offsets;
+  // All IDs back to back, ID i is [_id_offsets[i], _id_offsets[i + 1])
+  std::vector<char> _id_chars;
+  std::vector<uint64_t> _id_offsets;
+  // Inverted index: the sketches containing _index_hashes[i] are
+  // _index_refs[_index_offsets[i]] to _index_refs[_index_offsets[i + 1]]
+  std::vector<uint32_t> _index_hashes;
+  std::vector<uint64_t> _index_offsets;
+  std::vector<uint32_t> _index_refs;
+  bool _dirty;
+  // File opened by open(), the arrays point into it
+  std::shared_ptr<const char> _file;
+  arrays_t _mapped;
 };
 }
 
-#endif
\ No newline at end of file
+#endif
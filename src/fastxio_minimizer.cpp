@@ -0,0 +1,182 @@
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <fastxio_common.h>
+#include <fastxio_record.h>
+#include <fastxio_kmer.h>
+#include <fastxio_minimizer.h>
+
+namespace FASTX {
+
+namespace {
+
+uint64_t kmer_mask(unsigned short k)
+{
+  return k >= 32 ? ~uint64_t(0) : (uint64_t(1) << (2 * k)) - 1;
+}
+
+sampled_kmer_t sample(const kmer_iterator& it, uint64_t mask)
+{
+  sampled_kmer_t ret;
+  ret.kmer = it.canonical();
+  ret.hash = kmer_hash(ret.kmer, mask);
+  ret.position = it.position();
+  ret.forward = it.forward() <= it.reverse();
+  return ret;
+}
+
+} // anonymous namespace
+
+kmer_window::kmer_window(size_t w) : _head(0), _tail(0)
+{
+  size_t n = 1;
+  while (n < w + 1)
+    n <<= 1;
+  _ring.resize(n);
+  _mask = n - 1;
+}
+
+minimizer_iterator::minimizer_iterator(unsigned short k, unsigned short w,
+                                       const char * seq, length_t len) :
+  _kmers(k, seq, len), _window(w), _mask(kmer_mask(k))
+{
+  init(w);
+}
+
+minimizer_iterator::minimizer_iterator(unsigned short k, unsigned short w,
+                                       const Record& r) :
+  _kmers(k, r), _window(w), _mask(kmer_mask(k))
+{
+  init(w);
+}
+
+minimizer_iterator::minimizer_iterator(unsigned short k, unsigned short w,
+                                       const PackedSequence& p) :
+  _kmers(k, p), _window(w), _mask(kmer_mask(k))
+{
+  init(w);
+}
+
+void minimizer_iterator::init(unsigned short w)
+{
+#ifndef NO_ERROR_CHECKING
+  if (w == 0)
+    throw std::runtime_error("Minimizer window must be at least 1");
+#endif
+  _w = w;
+  _run = 0;
+  _selected = false;
+  _end = false;
+  advance();
+}
+
+void minimizer_iterator::advance(void)
+{
+  for (; ! _kmers.end(); ++_kmers)
+  {
+    sampled_kmer_t x = sample(_kmers, _mask);
+    if (_run > 0 && x.position != _last + 1)
+    {
+      // A skipped base ends the stretch
+      _window.clear();
+      _run = 0;
+      _selected = false;
+    }
+    _last = x.position;
+    _run++;
+    _window.push(x);
+    if (_run < _w)
+      continue;
+
+    length_t start = x.position + 1 - _w;
+    _window.pop_before(start);
+    const sampled_kmer_t& m = _window.front();
+    if (_selected && _current.position >= start &&
+        (_current.hash == m.hash || _current.position == m.position))
+      continue;
+    _current = m;
+    _selected = true;
+    ++_kmers;
+    return;
+  }
+  _end = true;
+}
+
+syncmer_iterator::syncmer_iterator(unsigned short k, unsigned short s,
+                                   const char * seq, length_t len,
+                                   SyncmerType type, unsigned short offset) :
+  _smers(s, seq, len), _kmers(k, seq, len), _window(k >= s ? k - s + 1 : 1),
+  _smask(kmer_mask(s)), _kmask(kmer_mask(k)), _span(k - s + 1),
+  _type(type), _offset(offset)
+{
+  init();
+}
+
+syncmer_iterator::syncmer_iterator(unsigned short k, unsigned short s,
+                                   const Record& r,
+                                   SyncmerType type, unsigned short offset) :
+  _smers(s, r), _kmers(k, r), _window(k >= s ? k - s + 1 : 1),
+  _smask(kmer_mask(s)), _kmask(kmer_mask(k)), _span(k - s + 1),
+  _type(type), _offset(offset)
+{
+  init();
+}
+
+syncmer_iterator::syncmer_iterator(unsigned short k, unsigned short s,
+                                   const PackedSequence& p,
+                                   SyncmerType type, unsigned short offset) :
+  _smers(s, p), _kmers(k, p), _window(k >= s ? k - s + 1 : 1),
+  _smask(kmer_mask(s)), _kmask(kmer_mask(k)), _span(k - s + 1),
+  _type(type), _offset(offset)
+{
+  init();
+}
+
+void syncmer_iterator::init(void)
+{
+#ifndef NO_ERROR_CHECKING
+  if (_kmers.k() <= _smers.k())
+    throw std::runtime_error("The s-mer size must be smaller than k");
+  if (_type == SyncmerType::OPEN && _offset >= _span)
+    throw std::runtime_error("The open syncmer offset must be at most k - s");
+#endif
+  _run = 0;
+  _end = false;
+  advance();
+}
+
+void syncmer_iterator::advance(void)
+{
+  for (; ! _smers.end(); ++_smers)
+  {
+    sampled_kmer_t x = sample(_smers, _smask);
+    if (_run > 0 && x.position != _last + 1)
+    {
+      _window.clear();
+      _run = 0;
+    }
+    _last = x.position;
+    _run++;
+    _window.push(x);
+    if (_run < _span)
+      continue;
+
+    length_t start = x.position + 1 - _span; // Start of the k-mer
+    _window.pop_before(start);
+    length_t at = _window.front().position - start;
+    bool sync = _type == SyncmerType::OPEN ? at == _offset
+                                           : (at == 0 || at == _span - 1u);
+    if (! sync)
+      continue;
+
+    // Both iterators skip the same bases, so the k-mer is always found
+    while (_kmers.position() < start)
+      ++_kmers;
+    _current = sample(_kmers, _kmask);
+    ++_smers;
+    return;
+  }
+  _end = true;
+}
+
+}
@@ -0,0 +1,293 @@
+#ifndef _FASTX_IO_MINIMIZER_H_
+#define _FASTX_IO_MINIMIZER_H_
+
+#include <vector>
+#include <cstdint>
+#include <fastxio_common.h>
+#include <fastxio_record.h>
+#include <fastxio_kmer.h>
+
+namespace FASTX {
+
+/**
+ * @brief Invertible hash of a 2-bit encoded k-mer
+ *
+ * @param kmer The encoded k-mer
+ * @param mask Mask of the 2k bits in use
+ * @return A hash of the same width as the k-mer
+ */
+inline uint64_t kmer_hash(uint64_t kmer, uint64_t mask)
+{
+  kmer = (~kmer + (kmer << 21)) & mask;
+  kmer = kmer ^ kmer >> 24;
+  kmer = ((kmer + (kmer << 3)) + (kmer << 8)) & mask;
+  kmer = kmer ^ kmer >> 14;
+  kmer = ((kmer + (kmer << 2)) + (kmer << 4)) & mask;
+  kmer = kmer ^ kmer >> 28;
+  kmer = (kmer + (kmer << 31)) & mask;
+  return kmer;
+}
+
+/**
+ * @brief A k-mer selected by a minimizer or syncmer scheme
+ */
+struct sampled_kmer_t
+{
+  uint64_t kmer = 0;     /**< Canonical 2-bit encoded k-mer */
+  uint64_t hash = 0;     /**< `kmer_hash()` of the canonical k-mer */
+  length_t position = 0; /**< (0-offset) start of the k-mer */
+  bool forward = true;   /**< The canonical k-mer is on the forward strand */
+};
+
+/**
+ * @brief Sliding window minimum of k-mer hashes
+ *
+ * A monotone deque on a ring buffer: hashes increase from front to back,
+ * so the front is the minimum of the window, and every k-mer is pushed
+ * and popped at most once. On ties the rightmost k-mer is kept.
+ */
+class kmer_window
+{
+public:
+  /**
+   * @brief Constructor
+   *
+   * @param w The maximum number of k-mers in the window
+   */
+  explicit kmer_window(size_t w);
+
+  /**
+   * @brief Remove all k-mers
+   */
+  void clear(void) { _head = _tail; }
+
+  /**
+   * @brief Check if the window is empty
+   */
+  bool empty(void) const { return _head == _tail; }
+
+  /**
+   * @brief Add a k-mer, dropping all k-mers with a larger or equal hash
+   */
+  void push(const sampled_kmer_t& x) {
+    while (_tail != _head && _ring[(_tail - 1) & _mask].hash >= x.hash)
+      _tail--;
+    _ring[_tail++ & _mask] = x;
+  }
+
+  /**
+   * @brief Drop k-mers that start before a position
+   */
+  void pop_before(length_t start) {
+    while (_head != _tail && _ring[_head & _mask].position < start)
+      _head++;
+  }
+
+  /**
+   * @brief The k-mer with the smallest hash
+   */
+  const sampled_kmer_t& front(void) const { return _ring[_head & _mask]; }
+
+private:
+  std::vector<sampled_kmer_t> _ring;
+  size_t _mask;
+  size_t _head;
+  size_t _tail;
+};
+
+/**
+ * @brief Streaming (w, k) minimizers of a sequence
+ *
+ * Of every w consecutive k-mers the one with the smallest hash of its
+ * canonical k-mer is selected. Ties are resolved by robust winnowing
+ * (Schleimer et al. 2003): the previously selected k-mer is kept while it
+ * is in the window, otherwise the rightmost smallest k-mer is chosen.
+ * Every selected k-mer is reported once, in order of position. Windows do
+ * not span non-ACGT bases, stretches with fewer than w k-mers yield no
+ * minimizers.
+ *
+ * The iterator works on raw sequences, records and packed sequences,
+ * which have to outlive it.
+ */
+class minimizer_iterator
+{
+public:
+  /**
+   * @brief Constructor on a raw sequence
+   *
+   * @param k The k-mer size (at most 32)
+   * @param w The number of k-mers per window
+   * @param seq Pointer to the sequence
+   * @param len Length of the sequence
+   */
+  minimizer_iterator(unsigned short k, unsigned short w,
+                     const char * seq, length_t len);
+
+  /**
+   * @brief Constructor on a record
+   *
+   * @param k The k-mer size (at most 32)
+   * @param w The number of k-mers per window
+   * @param r A `Record` object
+   */
+  minimizer_iterator(unsigned short k, unsigned short w, const Record& r);
+
+  /**
+   * @brief Constructor on a packed sequence
+   *
+   * @param k The k-mer size (at most 32)
+   * @param w The number of k-mers per window
+   * @param p A `PackedSequence` object
+   */
+  minimizer_iterator(unsigned short k, unsigned short w,
+                     const PackedSequence& p);
+
+  /**
+   * @brief Move to the next minimizer
+   */
+  minimizer_iterator& operator++() {
+    advance();
+    return *this;
+  }
+
+  /**
+   * @brief Check if all minimizers have been visited
+   */
+  bool end(void) const { return _end; }
+
+  /**
+   * @brief The current minimizer
+   */
+  const sampled_kmer_t& operator*() const { return _current; }
+
+  /**
+   * @brief Access the current minimizer
+   */
+  const sampled_kmer_t* operator->() const { return &_current; }
+
+private:
+  void init(unsigned short w);
+  void advance(void);
+
+  kmer_iterator _kmers;
+  kmer_window _window;
+  uint64_t _mask;
+  unsigned short _w;
+  length_t _run;  // Consecutive k-mers in the current stretch
+  length_t _last; // Position of the last k-mer
+  sampled_kmer_t _current;
+  bool _selected;
+  bool _end;
+
+  /**
+   * Examples
+   *  @example minimizers.cpp
+   */
+};
+
+/**
+ * @brief Kind of syncmer
+ */
+enum class SyncmerType
+{
+  OPEN,  /**< The smallest s-mer is at a fixed offset */
+  CLOSED /**< The smallest s-mer is the first or the last one */
+};
+
+/**
+ * @brief Streaming syncmers of a sequence
+ *
+ * A k-mer is a syncmer if the smallest hash of its canonical s-mers
+ * (s < k) is at a given position within the k-mer (Edgar 2021). Unlike
+ * minimizers, the selection of a k-mer does not depend on its neighbours.
+ * The smallest s-mers are tracked with the same monotone deque as
+ * minimizers, ties are resolved to the rightmost s-mer.
+ */
+class syncmer_iterator
+{
+public:
+  /**
+   * @brief Constructor on a raw sequence
+   *
+   * @param k The k-mer size (at most 32)
+   * @param s The s-mer size (smaller than k)
+   * @param seq Pointer to the sequence
+   * @param len Length of the sequence
+   * @param type Open or closed syncmers
+   * @param offset Position of the smallest s-mer in open syncmers
+   */
+  syncmer_iterator(unsigned short k, unsigned short s,
+                   const char * seq, length_t len,
+                   SyncmerType type = SyncmerType::OPEN,
+                   unsigned short offset = 0);
+
+  /**
+   * @brief Constructor on a record
+   *
+   * @param k The k-mer size (at most 32)
+   * @param s The s-mer size (smaller than k)
+   * @param r A `Record` object
+   * @param type Open or closed syncmers
+   * @param offset Position of the smallest s-mer in open syncmers
+   */
+  syncmer_iterator(unsigned short k, unsigned short s, const Record& r,
+                   SyncmerType type = SyncmerType::OPEN,
+                   unsigned short offset = 0);
+
+  /**
+   * @brief Constructor on a packed sequence
+   *
+   * @param k The k-mer size (at most 32)
+   * @param s The s-mer size (smaller than k)
+   * @param p A `PackedSequence` object
+   * @param type Open or closed syncmers
+   * @param offset Position of the smallest s-mer in open syncmers
+   */
+  syncmer_iterator(unsigned short k, unsigned short s,
+                   const PackedSequence& p,
+                   SyncmerType type = SyncmerType::OPEN,
+                   unsigned short offset = 0);
+
+  /**
+   * @brief Move to the next syncmer
+   */
+  syncmer_iterator& operator++() {
+    advance();
+    return *this;
+  }
+
+  /**
+   * @brief Check if all syncmers have been visited
+   */
+  bool end(void) const { return _end; }
+
+  /**
+   * @brief The current syncmer
+   */
+  const sampled_kmer_t& operator*() const { return _current; }
+
+  /**
+   * @brief Access the current syncmer
+   */
+  const sampled_kmer_t* operator->() const { return &_current; }
+
+private:
+  void init(void);
+  void advance(void);
+
+  kmer_iterator _smers;
+  kmer_iterator _kmers;
+  kmer_window _window;
+  uint64_t _smask;
+  uint64_t _kmask;
+  unsigned short _span; // s-mers per k-mer
+  SyncmerType _type;
+  unsigned short _offset;
+  length_t _run;  // Consecutive s-mers in the current stretch
+  length_t _last; // Position of the last s-mer
+  sampled_kmer_t _current;
+  bool _end;
+};
+
+}
+#endif
@@ -0,0 +1,197 @@
+#ifndef _FASTX_IO_NTHASH_H_
+#define _FASTX_IO_NTHASH_H_
+
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+#include <fastxio_common.h>
+#include <fastxio_record.h>
+
+namespace FASTX {
+
+/**
+ * @brief Rolling ntHash values of all k-mers of a sequence
+ *
+ * The forward and reverse complement hashes of a k-mer are derived from
+ * those of the previous k-mer by a few rotations and XORs (ntHash,
+ * Mohamadi et al. 2016), so each step is O(1) independent of k. The
+ * canonical hash, the smaller of both, is the same for a k-mer and its
+ * reverse complement. Additional hashes per k-mer are derived from the
+ * canonical hash by a multiplication, see `hash()`.
+ *
+ * K-mers that contain anything but A, C, G or T/U are skipped. The
+ * iterator only keeps a pointer to the sequence, which has to outlive it.
+ */
+class nthash_iterator
+{
+public:
+  /**
+   * @brief Constructor on a raw sequence
+   *
+   * @param k The k-mer size
+   * @param seq Pointer to the sequence
+   * @param len Length of the sequence
+   */
+  nthash_iterator(unsigned short k, const char * seq, length_t len) :
+    _seq(seq), _len(len), _next(0), _valid(0), _k(k),
+    _fwd(0), _rev(0), _end(false)
+  {
+#ifndef NO_ERROR_CHECKING
+    if (k == 0)
+      throw std::runtime_error("K-mer size must be at least 1");
+#endif
+    for (unsigned char c = 0; c < 4; c++)
+    {
+      _out_fwd[c] = rol(seed(c), k);
+      _out_rev[c] = ror(seed(3 - c), 1);
+      _in_rev[c] = rol(seed(3 - c), k - 1);
+    }
+    advance();
+  }
+
+  /**
+   * @brief Constructor on a record
+   *
+   * @param k The k-mer size
+   * @param r A `Record` object, which has to outlive the iterator
+   */
+  nthash_iterator(unsigned short k, const Record& r) :
+    nthash_iterator(k, r.get_seq().data(), r.size()) {}
+
+  /**
+   * @brief Move to the next valid k-mer
+   */
+  nthash_iterator& operator++() {
+    advance();
+    return *this;
+  }
+
+  /**
+   * @brief Check if all k-mers have been visited
+   *
+   * @return True if there is no current k-mer
+   */
+  bool end() const { return _end; }
+
+  /**
+   * @brief The canonical hash of the current k-mer
+   */
+  uint64_t operator*() const { return canonical(); }
+
+  /**
+   * @brief The hash of the current k-mer
+   */
+  uint64_t forward() const { return _fwd; }
+
+  /**
+   * @brief The hash of the reverse complement of the current k-mer
+   */
+  uint64_t reverse() const { return _rev; }
+
+  /**
+   * @brief The strand independent hash of the current k-mer
+   */
+  uint64_t canonical() const { return _fwd < _rev ? _fwd : _rev; }
+
+  /**
+   * @brief Check which strand the canonical hash comes from
+   *
+   * @return True if the canonical hash is the forward hash
+   */
+  bool is_forward() const { return _fwd <= _rev; }
+
+  /**
+   * @brief The i-th canonical hash of the current k-mer
+   *
+   * Hash 0 is `canonical()`, further hashes are computed on demand with
+   * one multiplication each.
+   *
+   * @param i The index of the hash
+   */
+  uint64_t hash(unsigned short i) const {
+    if (i == 0)
+      return canonical();
+    uint64_t h = canonical() * (i ^ _k * multi_seed);
+    return h ^ (h >> multi_shift);
+  }
+
+  /**
+   * @brief The (0-offset) start position of the current k-mer
+   */
+  length_t position() const { return _next - _k; }
+
+  /**
+   * @brief The k-mer size
+   */
+  unsigned short k() const { return _k; }
+
+  /**
+   * @brief The ntHash seed of a 2-bit encoded base
+   *
+   * @param c The base (A = 0, C = 1, G = 2, T = 3)
+   */
+  static uint64_t seed(unsigned char c) {
+    static const uint64_t seeds[4] = {
+      0x3c8bfbb395c60474, 0x3193c18562a02b4c,
+      0x20323ed082572324, 0x295549f54be24456
+    };
+    return seeds[c];
+  }
+
+private:
+  static const uint64_t multi_seed = 0x90b45d39fb6da1fa;
+  static const unsigned multi_shift = 27;
+
+  static uint64_t rol(uint64_t x, unsigned n) {
+    n &= 63;
+    return (x << n) | (x >> ((64 - n) & 63));
+  }
+
+  static uint64_t ror(uint64_t x, unsigned n) {
+    n &= 63;
+    return (x >> n) | (x << ((64 - n) & 63));
+  }
+
+  void advance() {
+    while (_next < _len)
+    {
+      unsigned char c = GData::twobit[static_cast<unsigned char>(_seq[_next++])];
+      if (c > 3)
+      {
+        _valid = 0;
+        _fwd = 0;
+        _rev = 0;
+        continue;
+      }
+      if (_valid < _k)
+      {
+        // Build up the first k-mer after a start or a skipped base
+        _fwd = rol(_fwd, 1) ^ seed(c);
+        _rev ^= rol(seed(3 - c), _valid);
+        if (++_valid == _k)
+          return;
+        continue;
+      }
+      unsigned char out = GData::twobit[static_cast<unsigned char>(_seq[_next - 1 - _k])];
+      _fwd = rol(_fwd, 1) ^ _out_fwd[out] ^ seed(c);
+      _rev = ror(_rev, 1) ^ _out_rev[out] ^ _in_rev[c];
+      return;
+    }
+    _end = true;
+  }
+
+  const char * _seq;
+  length_t _len;
+  length_t _next;  // Next base to read
+  length_t _valid; // Valid bases since the last skipped one, up to k
+  unsigned short _k;
+  uint64_t _fwd;
+  uint64_t _rev;
+  uint64_t _out_fwd[4]; // Rotated seeds of the base leaving the k-mer
+  uint64_t _out_rev[4];
+  uint64_t _in_rev[4];  // Rotated seeds of the base entering the k-mer
+  bool _end;
+};
+
+}
+#endif
@@ -16,68 +16,127 @@
 #include <matrix.h>
 #include <set>
 #include <map>
+#include <exception>
+#include <stdexcept>
 #include <fastxio_common.h>
 #include <fastxio_nuc_frequency.h>
 #include <fastxio_record.h>
+#include <fastxio_reader.h>
+#include <fastxio_simd.h>
 
 namespace FASTX {
 
 // Print nucleotide frequency
 std::ostream& operator<<(std::ostream& outstream, const NucFrequency nuc)
 {
-  for (auto c : nuc._freq_table)
-    outstream << c.first << '\t' << c.second << '\n';
+  for (unsigned c = 0; c < 256; c++)
+  {
+    if (nuc._counts[c])
+      outstream << static_cast<char>(c) << '\t' << nuc._counts[c] << '\n';
+  }
   return outstream;
 }
 
 // Count nucleotides
 void NucFrequency::add(const std::string& seq)
 {
-  for (char c : seq)
-  {
-    _freq_table[c]++;
-  }
+  byte_histogram(seq.data(), seq.size(), _counts.data());
 }
 
 void NucFrequency::add(const Record& rec)
 {
-  for (char c : rec._seq)
-  {
-    _freq_table[c]++;
-  }
+  byte_histogram(rec._seq.data(), rec._seq.size(), _counts.data());
 }
 
-length_t NucFrequency::at(char nuc) const
+void NucFrequency::add(const char * seq, length_t len)
 {
-  return _freq_table.at(nuc);
+  byte_histogram(seq, len, _counts.data());
 }
 
-length_t NucFrequency::operator[](char nuc)
+void NucFrequency::merge(const NucFrequency& other)
 {
-  return _freq_table[nuc];
+  for (unsigned c = 0; c < 256; c++)
+    _counts[c] += other._counts[c];
+}
+
+uint64_t NucFrequency::total(void) const
+{
+  uint64_t sum = 0;
+  for (uint64_t n : _counts)
+    sum += n;
+  return sum;
+}
+
+length_t NucFrequency::at(char nuc) const
+{
+  length_t n = _counts[static_cast<unsigned char>(nuc)];
+  if (n == 0)
+    throw std::out_of_range(std::string("Letter not in table: ") + nuc);
+  return n;
 }
 
 std::vector<char> NucFrequency::letters(void) const
 {
   std::vector<char> ret;
-  for (auto c : _freq_table)
-    ret.push_back(c.first);
+  for (unsigned c = 0; c < 256; c++)
+  {
+    if (_counts[c])
+      ret.push_back(static_cast<char>(c));
+  }
   return ret;
 }
 
 std::ostream& operator<<(std::ostream& outstream, NucPercent rhs)
 {
-  uint64_t sum = 0;
-  for (auto& i : rhs._freq._freq_table)
-    sum += i.second;
-
-  double dsum = lexical_double(sum);
-  for (auto& i : rhs._freq._freq_table)
+  double dsum = lexical_double(rhs._freq.total());
+  for (unsigned c = 0; c < 256; c++)
   {
-    outstream << i.first << '\t' << lexical_double(i.second) / dsum * 100 << '\n';
+    if (rhs._freq._counts[c])
+      outstream << static_cast<char>(c) << '\t'
+                << lexical_double(rhs._freq._counts[c]) / dsum * 100 << '\n';
   }
 
   return outstream;
 }
 
-};
+NucFrequency count_freq(Reader& reader, size_t batch_size)
+{
+  NucFrequency ret;
+  std::vector<Record> batch;
+  std::vector<Record> next;
+  reader.next_batch(batch, batch_size);
+  while (! batch.empty())
+  {
+    // Parse errors of the next batch are raised after the region
+    std::exception_ptr error;
+    int64_t n = batch.size();
+    #pragma omp parallel
+    {
+      #pragma omp single nowait
+      {
+        try
+        {
+          reader.next_batch(next, batch_size);
+        }
+        catch (...)
+        {
+          error = std::current_exception();
+        }
+      }
+      NucFrequency local;
+      #pragma omp for schedule(dynamic, 64) nowait
+      for (int64_t i = 0; i < n; i++)
+      {
+        local.add(batch[i]);
+      }
+      #pragma omp critical
+      ret.merge(local);
+    }
+    if (error)
+      std::rethrow_exception(error);
+    batch.swap(next);
+  }
+  return ret;
+}
+
+}
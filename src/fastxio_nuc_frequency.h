@@ -3,20 +3,25 @@
 
 #include <string>
 #include <fstream>
-#include <map>
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <fastxio_common.h>
 
 namespace FASTX {
 
 // Forward declarations
 class Record;
+class Reader;
 class NucPercent;
 
 /**
  * @brief Helper class to count nucleotide frequencies
  *
  * The NucFrequency class here is a helper class to compute
- * nucleotide frequency tables. Currently, it is implemented
- * with `std::map` as a red-black BST.
+ * nucleotide frequency tables. The counts are kept in a flat table
+ * with one entry per byte value, filled by `byte_histogram()`. Tables
+ * of different threads can be combined with `merge()`.
  */
 class NucFrequency {
 public:
@@ -45,11 +50,40 @@ public:
    */
   void add(const Record& str);
 
+  /**
+   * @brief Add all characters of a buffer to the table
+   *
+   * @param seq Pointer to the sequence
+   * @param len Length of the sequence
+   */
+  void add(const char * seq, length_t len);
+
+  /**
+   * @brief Add the counts of another table
+   *
+   * @param other Another NucFrequency object, e.g. of another thread
+   */
+  void merge(const NucFrequency& other);
+
+  /**
+   * @brief Add the counts of another table, see `merge()`
+   */
+  NucFrequency& operator+=(const NucFrequency& other) {
+    merge(other);
+    return *this;
+  }
+
+  /**
+   * @brief Total number of counted characters
+   */
+  uint64_t total(void) const;
+
   /**
    * @brief Extract data for a letter with bounds checking
    *
    * @param nuc The letter of interest
    * @return Counts of the letter of interest
+   * @throw std::out_of_range If the letter was never seen
    */
   length_t at(char nuc) const;
 
@@ -57,9 +91,11 @@ public:
    * @brief Extract data for a letter
    *
    * @param nuc The letter of interest
-   * @return Counts of the letter of interest
+   * @return Counts of the letter of interest, 0 if it was never seen
    */
-  length_t operator[](char nuc);
+  length_t operator[](char nuc) const {
+    return _counts[static_cast<unsigned char>(nuc)];
+  }
 
   /**
    * @brief Get a vector of the letters in the count table
@@ -71,12 +107,25 @@ public:
   /**
    * @brief NULL constructor
    */
-  NucFrequency(void) {};
+  NucFrequency(void) : _counts() {};
 
 private:
-  std::map<char, length_t> _freq_table;
+  std::array<uint64_t, 256> _counts;
 };
 
+/**
+ * @brief Count the characters of all records of a reader
+ *
+ * Records are read in batches. If the library was built with OpenMP, one
+ * thread reads the next batch while the others count the current one
+ * into their own tables, which are merged at the end.
+ *
+ * @param reader A reader, it is consumed to the end
+ * @param batch_size The number of records per batch
+ * @return The counts over all records
+ */
+NucFrequency count_freq(Reader& reader, size_t batch_size = 4096);
+
 /**
 * @brief Helper class to wrap FASTA when printing
 *
@@ -0,0 +1,266 @@
+#include <string>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <ostream>
+#include <cstdint>
+#include <fastxio_common.h>
+#include <fastxio_record.h>
+#include <fastxio_qc.h>
+
+namespace FASTX {
+
+namespace {
+
+// Smallest score reaching a fraction of a histogram
+unsigned short quantile(const uint64_t * hist, unsigned n, uint64_t total,
+                        double fraction)
+{
+  double target = fraction * total;
+  uint64_t cum = 0;
+  for (unsigned q = 0; q < n; q++)
+  {
+    cum += hist[q];
+    if (cum > 0 && cum >= target)
+      return q;
+  }
+  return n - 1;
+}
+
+// JSON string literal, unvalidated reads may contain any byte
+void write_json_string(std::ostream& out, const std::string& s)
+{
+  static const char hex[] = "0123456789abcdef";
+  out << '"';
+  for (char c : s)
+  {
+    unsigned char u = static_cast<unsigned char>(c);
+    if (c == '"' || c == '\\')
+      out << '\\' << c;
+    else if (u < 0x20 || u >= 0x7f)
+      out << "\\u00" << hex[u >> 4] << hex[u & 15];
+    else
+      out << c;
+  }
+  out << '"';
+}
+
+// Pairs of [index, count] of the nonzero entries
+template <typename T>
+void write_histogram(std::ostream& out, const T& hist)
+{
+  out << '[';
+  bool first = true;
+  for (size_t i = 0; i < hist.size(); i++)
+  {
+    if (hist[i] == 0)
+      continue;
+    out << (first ? "" : ",") << '[' << i << ',' << hist[i] << ']';
+    first = false;
+  }
+  out << ']';
+}
+
+} // anonymous namespace
+
+QcProfile::QcProfile(unsigned short offset, length_t key_length,
+                     size_t max_unique) :
+  _offset(offset), _key_length(key_length), _max_unique(max_unique),
+  _reads(0), _total_bases(0), _qual_reads(0), _lengths(1, 0),
+  _mean_qual(), _gc()
+{
+}
+
+void QcProfile::grow(length_t length)
+{
+  _bases.resize(length * 5, 0);
+  _quals.resize(length * (MAX_QUAL + 1), 0);
+  _lengths.resize(length + 1, 0);
+}
+
+void QcProfile::add(const Record& r)
+{
+  const length_t len = r.size();
+  if (len >= _lengths.size())
+    grow(len);
+  _reads++;
+  _total_bases += len;
+  _lengths[len]++;
+
+  const unsigned char * seq =
+    reinterpret_cast<const unsigned char *>(r.get_seq().data());
+  uint64_t * bases = _bases.data();
+  length_t gc = 0;
+  length_t called = 0;
+  for (length_t i = 0; i < len; i++)
+  {
+    unsigned char b = GData::twobit[seq[i]];
+    bases[i * 5 + b]++;
+    called += b < 4;
+    gc += b == 1 || b == 2;
+  }
+  if (called > 0)
+    _gc[(200 * gc + called) / (2 * called)]++;
+
+  if ((r.get_type() & FASTQ_TYPE) && len > 0)
+  {
+    const unsigned char * qual =
+      reinterpret_cast<const unsigned char *>(r.get_qual().data());
+    uint64_t * quals = _quals.data();
+    uint64_t sum = 0;
+    for (length_t i = 0; i < len; i++)
+    {
+      unsigned q = qual[i] > _offset ? qual[i] - _offset : 0;
+      q = q > MAX_QUAL ? MAX_QUAL : q;
+      quals[i * (MAX_QUAL + 1) + q]++;
+      sum += q;
+    }
+    _mean_qual[(2 * sum + len) / (2 * len)]++;
+    _qual_reads++;
+  }
+
+  _key.assign(r.get_seq(), 0, _key_length);
+  auto it = _overrep.find(_key);
+  if (it != _overrep.end())
+    it->second++;
+  else if (_overrep.size() < _max_unique)
+    _overrep.emplace(_key, 1);
+}
+
+void QcProfile::add(const std::vector<Record>& batch)
+{
+  int64_t n = batch.size();
+  #pragma omp parallel
+  {
+    QcProfile local(_offset, _key_length, _max_unique);
+    #pragma omp for schedule(static)
+    for (int64_t i = 0; i < n; i++)
+    {
+      local.add(batch[i]);
+    }
+    #pragma omp critical
+    merge(local);
+  }
+}
+
+void QcProfile::merge(const QcProfile& other)
+{
+  if (other._lengths.size() > _lengths.size())
+    grow(other._lengths.size() - 1);
+  _reads += other._reads;
+  _total_bases += other._total_bases;
+  _qual_reads += other._qual_reads;
+  for (size_t i = 0; i < other._bases.size(); i++)
+    _bases[i] += other._bases[i];
+  for (size_t i = 0; i < other._quals.size(); i++)
+    _quals[i] += other._quals[i];
+  for (size_t i = 0; i < other._lengths.size(); i++)
+    _lengths[i] += other._lengths[i];
+  for (size_t i = 0; i < _mean_qual.size(); i++)
+    _mean_qual[i] += other._mean_qual[i];
+  for (size_t i = 0; i < _gc.size(); i++)
+    _gc[i] += other._gc[i];
+  for (const auto& s : other._overrep)
+  {
+    auto it = _overrep.find(s.first);
+    if (it != _overrep.end())
+      it->second += s.second;
+    else if (_overrep.size() < _max_unique)
+      _overrep.insert(s);
+  }
+}
+
+quality_quantiles_t QcProfile::quality(length_t cycle) const
+{
+  quality_quantiles_t ret;
+  const uint64_t * hist = _quals.data() + cycle * (MAX_QUAL + 1);
+  uint64_t total = 0;
+  uint64_t sum = 0;
+  for (unsigned q = 0; q <= MAX_QUAL; q++)
+  {
+    total += hist[q];
+    sum += hist[q] * q;
+  }
+  if (total == 0)
+    return ret;
+  ret.mean = static_cast<double>(sum) / total;
+  ret.p10 = quantile(hist, MAX_QUAL + 1, total, 0.1);
+  ret.q1 = quantile(hist, MAX_QUAL + 1, total, 0.25);
+  ret.median = quantile(hist, MAX_QUAL + 1, total, 0.5);
+  ret.q3 = quantile(hist, MAX_QUAL + 1, total, 0.75);
+  ret.p90 = quantile(hist, MAX_QUAL + 1, total, 0.9);
+  return ret;
+}
+
+std::vector<std::pair<std::string, uint64_t>>
+QcProfile::overrepresented(double min_fraction) const
+{
+  std::vector<std::pair<std::string, uint64_t>> ret;
+  for (const auto& s : _overrep)
+  {
+    if (s.second > 1 && s.second >= min_fraction * _reads)
+      ret.push_back(s);
+  }
+  std::sort(ret.begin(), ret.end(),
+            [](const std::pair<std::string, uint64_t>& a,
+               const std::pair<std::string, uint64_t>& b)
+            {
+              return a.second != b.second ? a.second > b.second :
+                a.first < b.first;
+            });
+  return ret;
+}
+
+void QcProfile::write_json(std::ostream& out, double min_fraction) const
+{
+  const char names[5] = {'A', 'C', 'G', 'T', 'N'};
+  out << "{\n  \"reads\": " << _reads << ",\n  \"bases\": " << _total_bases
+      << ",\n  \"length_distribution\": ";
+  write_histogram(out, _lengths);
+
+  out << ",\n  \"base_composition\": [";
+  for (length_t c = 0; c < cycles(); c++)
+  {
+    uint64_t total = 0;
+    for (unsigned b = 0; b < 5; b++)
+      total += base_count(c, b);
+    out << (c ? "," : "") << "\n    {\"cycle\": " << c + 1;
+    for (unsigned b = 0; b < 5; b++)
+      out << ", \"" << names[b] << "\": "
+          << (total ? 100.0 * base_count(c, b) / total : 0.0);
+    out << '}';
+  }
+  out << "\n  ]";
+
+  if (_qual_reads > 0)
+  {
+    out << ",\n  \"quality\": [";
+    for (length_t c = 0; c < cycles(); c++)
+    {
+      quality_quantiles_t q = quality(c);
+      out << (c ? "," : "") << "\n    {\"cycle\": " << c + 1
+          << ", \"mean\": " << q.mean << ", \"p10\": " << q.p10
+          << ", \"q1\": " << q.q1 << ", \"median\": " << q.median
+          << ", \"q3\": " << q.q3 << ", \"p90\": " << q.p90 << '}';
+    }
+    out << "\n  ],\n  \"mean_quality_distribution\": ";
+    write_histogram(out, _mean_qual);
+  }
+
+  out << ",\n  \"gc_distribution\": ";
+  write_histogram(out, _gc);
+
+  out << ",\n  \"overrepresented\": [";
+  bool first = true;
+  for (const auto& s : overrepresented(min_fraction))
+  {
+    out << (first ? "" : ",") << "\n    {\"sequence\": ";
+    write_json_string(out, s.first);
+    out << ", \"count\": " << s.second << ", \"percent\": "
+        << 100.0 * s.second / _reads << '}';
+    first = false;
+  }
+  out << (first ? "]" : "\n  ]") << "\n}\n";
+}
+
+}
@@ -0,0 +1,175 @@
+#ifndef _FASTX_IO_QC_H_
+#define _FASTX_IO_QC_H_
+
+#include <string>
+#include <vector>
+#include <array>
+#include <unordered_map>
+#include <ostream>
+#include <cstdint>
+#include <fastxio_common.h>
+#include <fastxio_record.h>
+
+namespace FASTX {
+
+/**
+ * @brief Quantiles of a quality score histogram
+ */
+struct quality_quantiles_t
+{
+  double mean = 0;
+  unsigned short p10 = 0;
+  unsigned short q1 = 0;
+  unsigned short median = 0;
+  unsigned short q3 = 0;
+  unsigned short p90 = 0;
+};
+
+/**
+ * @brief Accumulator of read QC statistics (similar to FastQC)
+ *
+ * The profile collects per-cycle base composition, per-cycle quality
+ * histograms, the read length distribution, the distribution of the
+ * per-read mean quality, the GC distribution and the most frequent read
+ * prefixes. Per-cycle counters are stored row by row, one row per cycle,
+ * so a read updates consecutive memory. Profiles of different threads
+ * are combined with `merge()`, `add()` on a batch does this internally.
+ *
+ * Overrepresented sequences are counted on the first `key_length` bases
+ * of every read. New sequences are only tracked until `max_unique`
+ * sequences are known, later reads are only counted if they match a
+ * known one. Which sequences make it into the table near the limit may
+ * depend on the order in which thread profiles are merged.
+ */
+class QcProfile
+{
+public:
+  /**
+   * @brief Constructor
+   *
+   * @param offset The PHRED offset, see `scan_phred()`
+   * @param key_length Number of leading bases compared for
+   * overrepresented sequences
+   * @param max_unique Maximum number of distinct sequences tracked for
+   * overrepresented sequences
+   */
+  QcProfile(unsigned short offset = 33, length_t key_length = 50,
+            size_t max_unique = 100000);
+
+  /**
+   * @brief Add a record
+   *
+   * @param r A FASTQ or FASTA record, the quality statistics are only
+   * collected for FASTQ
+   */
+  void add(const Record& r);
+
+  /**
+   * @brief Add a batch of records
+   *
+   * Records are processed in parallel if the library was built with
+   * OpenMP, every thread fills its own profile that is merged at the end.
+   *
+   * @param batch A vector of records, e.g. from `Reader::next_batch()`
+   */
+  void add(const std::vector<Record>& batch);
+
+  /**
+   * @brief Add the counts of another profile
+   *
+   * @param other A profile with the same PHRED offset
+   */
+  void merge(const QcProfile& other);
+
+  /**
+   * @brief Add the counts of another profile, see `merge()`
+   */
+  QcProfile& operator+=(const QcProfile& other) {
+    merge(other);
+    return *this;
+  }
+
+  /**
+   * @brief Number of reads
+   */
+  uint64_t reads(void) const { return _reads; }
+
+  /**
+   * @brief Number of bases
+   */
+  uint64_t bases(void) const { return _total_bases; }
+
+  /**
+   * @brief Number of cycles, the length of the longest read
+   */
+  length_t cycles(void) const { return _lengths.size() - 1; }
+
+  /**
+   * @brief Count of a base at a cycle
+   *
+   * @param cycle The (0-offset) cycle
+   * @param base 0-3 for A, C, G, T/U, 4 for all other characters
+   */
+  uint64_t base_count(length_t cycle, unsigned base) const {
+    return _bases[cycle * 5 + base];
+  }
+
+  /**
+   * @brief Quality score quantiles of a cycle
+   *
+   * @param cycle The (0-offset) cycle
+   */
+  quality_quantiles_t quality(length_t cycle) const;
+
+  /**
+   * @brief Number of reads of a length
+   */
+  uint64_t length_count(length_t length) const {
+    return length < _lengths.size() ? _lengths[length] : 0;
+  }
+
+  /**
+   * @brief Sequences seen in more than a fraction of all reads
+   *
+   * @param min_fraction The minimum fraction of reads
+   * @return Sequences and counts, the most frequent first
+   */
+  std::vector<std::pair<std::string, uint64_t>>
+  overrepresented(double min_fraction = 0.001) const;
+
+  /**
+   * @brief Write all statistics as a JSON object
+   *
+   * @param outstream The output stream
+   * @param min_fraction The minimum fraction of reads for overrepresented
+   * sequences
+   */
+  void write_json(std::ostream& outstream, double min_fraction = 0.001) const;
+
+  static const unsigned MAX_QUAL = 63; /**< Higher scores are counted as 63 */
+
+private:
+  void grow(length_t length);
+
+  unsigned short _offset;
+  length_t _key_length;
+  size_t _max_unique;
+  uint64_t _reads;
+  uint64_t _total_bases;
+  uint64_t _qual_reads;
+  std::vector<uint64_t> _bases;    // 5 per cycle: A, C, G, T, other
+  std::vector<uint64_t> _quals;    // MAX_QUAL + 1 per cycle
+  std::vector<uint64_t> _lengths;  // Indexed by length
+  std::array<uint64_t, MAX_QUAL + 1> _mean_qual;
+  std::array<uint64_t, 101> _gc;   // Percent GC of A, C, G, T bases
+  std::unordered_map<std::string, uint64_t> _overrep;
+  std::string _key;
+
+  /**
+   * Examples
+   *  @example qc_profile.cpp
+   */
+};
+
+}
+#endif
@@ -24,8 +24,9 @@
 namespace FASTX {
 
 // Open filepath automatically and detect compression
-Reader::Reader(const char* infile, const char seqtype) :
-  _seqtype(seqtype)
+Reader::Reader(const char* infile, const char seqtype,
+               ValidationPolicy policy) :
+  _seqtype(seqtype), _policy(policy)
 {
   if (is_gzip(infile))
   {
@@ -50,7 +51,20 @@ Reader::Reader(const char* infile, const char seqtype) :
 // Get next record
 Record Reader::next(void)
 {
-  return Record(*_istream, _seqtype);
+  return Record(*_istream, _seqtype, _policy);
+}
+
+// Fill a batch, reusing its records
+size_t Reader::next_batch(std::vector<Record>& batch, size_t n)
+{
+  batch.resize(n);
+  size_t i = 0;
+  while (i < n && _istream->peek() != EOF)
+  {
+    batch[i++].read(*_istream, _seqtype, _policy);
+  }
+  batch.resize(i);
+  return i;
 }
 
 // Get next character
@@ -4,6 +4,7 @@
 #include <string>
 #include <memory>
 #include <fstream>
+#include <vector>
 #include <fastxio_record.h>
 
 namespace FASTX {
@@ -23,8 +24,10 @@ public:
    *
    * @param file A path to a file
    * @param seqtype The sequence type: DNA_SEQTYPE, RNA_SEQTYPE, AA_SEQTYPE
+   * @param policy The amount of validation performed on each record
    */
-  Reader(const char * file, const char seqtype);
+  Reader(const char * file, const char seqtype,
+         ValidationPolicy policy = default_validation);
 
   /**
    * @brief Return next record.
@@ -33,6 +36,20 @@ public:
    */
   Record next();
 
+  /**
+   * @brief Read a batch of records.
+   *
+   * The records of the batch are reused, so calling this repeatedly with
+   * the same vector does not allocate once the strings have grown to
+   * the size of the longest record. Batches can then be processed in
+   * parallel.
+   *
+   * @param batch A vector that is filled with up to n records
+   * @param n The maximum number of records to read
+   * @return The number of records read, 0 at the end of the file
+   */
+  size_t next_batch(std::vector<Record>& batch, size_t n);
+
   /**
    * @brief Peek the next character.
    *
@@ -62,9 +79,24 @@ public:
    *
    */
   void seek(int offset) { _istream->seekg(offset); }
+
+  /**
+   * @brief Change the validation policy for all following records.
+   *
+   * @param policy The amount of validation performed on each record
+   */
+  void set_validation(ValidationPolicy policy) { _policy = policy; }
+
+  /**
+   * @brief Get the validation policy.
+   *
+   * @return The amount of validation performed on each record
+   */
+  ValidationPolicy get_validation(void) const { return _policy; }
 private:
   std::unique_ptr<std::istream> _istream;
   const char _seqtype;
+  ValidationPolicy _policy;
 };
 
 }
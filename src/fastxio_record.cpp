@@ -18,21 +18,25 @@
 #include <set>
 #include <map>
 #include <fastxio_record.h>
+#include <fastxio_iupac.h>
 #include <fastxio_common.h>
 #include <fastxio_nuc_frequency.h>
 #include <fastxio_auxiliary.h>
+#include <fastxio_simd.h>
+#include <fastxio_translate.h>
 
 namespace FASTX {
 
 extern GData global; /**< Global variable of translation tables */
 
-//Istream constructor
-Record::Record(std::istream& input, char seqtype = DNA_SEQTYPE)
+// Parse one record, the validation policy is resolved at compile time
+template <ValidationPolicy P>
+void Record::parse(std::istream& input, char seqtype)
 {
   std::getline(input, _id);
-  if (_id.front() == '>')
+  if (! _id.empty() && _id.front() == '>')
     _type = (FASTA_TYPE | seqtype);
-  else if (_id.front() == '@')
+  else if (! _id.empty() && _id.front() == '@')
     _type = (FASTQ_TYPE | seqtype);
   else
     throw std::runtime_error("Could not determine format: " + _id);
@@ -40,9 +44,10 @@ Record::Record(std::istream& input, char seqtype = DNA_SEQTYPE)
   std::getline(input, _seq);
   if (_type & FASTA_TYPE)
   {
+    _qual.clear();
+    std::string app;
     while (is_sequence_char(input.peek(), seqtype))
     {
-      std::string app;
       std::getline(input, app);
       _seq.append(app);
     }
@@ -51,33 +56,92 @@ Record::Record(std::istream& input, char seqtype = DNA_SEQTYPE)
   }
   if (_type & FASTQ_TYPE)
   {
+    if (P != ValidationPolicy::NONE && input.peek() != '+')
+      throw std::runtime_error("Missing '+' separator for: " + _id);
     input.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     std::getline(input, _qual);
   }
-#ifndef NO_ERROR_CHECKING
-  this->validate();
-#endif
+  check<P>();
+}
+
+// Run all checks up to and including policy P
+template <ValidationPolicy P>
+void Record::check(void) const
+{
+  if (P == ValidationPolicy::NONE)
+    return;
+  if (_type & FASTQ_TYPE)
+  {
+    if (_qual.size() != _seq.size())
+      throw std::runtime_error("Qual and sequence are not the same "
+                               "length for: " + _id);
+  }
+  if (P == ValidationPolicy::STRUCTURAL)
+    return;
+  if (_type & (DNA_SEQTYPE | RNA_SEQTYPE | AA_SEQTYPE))
+  {
+    length_t pos = first_invalid_seq(_seq.data(), _seq.size(), _type);
+    if (pos != _seq.size())
+    {
+      std::string errmsg = "Unknown character ";
+      errmsg += _seq[pos];
+      throw std::runtime_error(errmsg + " in sequence: " + _id);
+    }
+  }
+  if (P == ValidationPolicy::ALPHABET)
+    return;
+  if (_type & FASTQ_TYPE)
+  {
+    length_t pos = first_invalid_qual(_qual.data(), _qual.size());
+    if (pos != _qual.size())
+      throw std::runtime_error("Impossible quality score " +
+                               std::to_string(_qual[pos]) +
+                               " in sequence: " + _id);
+  }
+}
+
+//Istream constructor
+Record::Record(std::istream& input, char seqtype = DNA_SEQTYPE,
+               ValidationPolicy policy)
+{
+  this->read(input, seqtype, policy);
+}
+
+void Record::read(std::istream& input, char seqtype, ValidationPolicy policy)
+{
+  switch (policy)
+  {
+  case ValidationPolicy::NONE:
+    parse<ValidationPolicy::NONE>(input, seqtype);
+    break;
+  case ValidationPolicy::STRUCTURAL:
+    parse<ValidationPolicy::STRUCTURAL>(input, seqtype);
+    break;
+  case ValidationPolicy::ALPHABET:
+    parse<ValidationPolicy::ALPHABET>(input, seqtype);
+    break;
+  case ValidationPolicy::FULL:
+    parse<ValidationPolicy::FULL>(input, seqtype);
+    break;
+  }
 }
 
 
 //FASTA sequence constructor
 Record::Record(const std::string& seq, const std::string& id,
-               char seqtype = DNA_SEQTYPE) :
+               char seqtype = DNA_SEQTYPE, ValidationPolicy policy) :
   _seq(seq), _id(id),  _type(FASTA_TYPE | seqtype)
 {
-#ifndef NO_ERROR_CHECKING
-  this->validate();
-#endif
+  this->validate(policy);
 }
 
 //FASTQ sequence constructor
 Record::Record(const std::string& seq, const std::string& id,
-               const std::string& qual, char seqtype = DNA_SEQTYPE) :
+               const std::string& qual, char seqtype = DNA_SEQTYPE,
+               ValidationPolicy policy) :
   _seq(seq), _id(id), _qual(qual),  _type(FASTQ_TYPE | seqtype)
 {
-#ifndef NO_ERROR_CHECKING
-  this->validate();
-#endif
+  this->validate(policy);
 }
 
 Record::Record(void) :
@@ -96,13 +160,7 @@ void Record::to_rna(void)
   _type = (_type | RNA_SEQTYPE);
   _type = (_type ^ DNA_SEQTYPE);
 
-  for (auto it = _seq.begin(); it != _seq.end(); it++)
-  {
-    if ( (*it) == 'T' )
-      *it = 'U';
-    else if ( (*it) == 't' )
-      *it = 'u';
-  }
+  dna_to_rna(&_seq[0], _seq.size());
 }
 
 void Record::to_dna(void)
@@ -116,66 +174,48 @@ void Record::to_dna(void)
   _type = (_type | DNA_SEQTYPE);
   _type = (_type ^ RNA_SEQTYPE);
 
-  for (auto it = _seq.begin(); it != _seq.end(); it++)
-  {
-    if ( (*it) == 'U' )
-      *it = 'T';
-    else if ( (*it) == 'u' )
-      *it = 't';
-  }
+  rna_to_dna(&_seq[0], _seq.size());
 }
 
-bool Record::validate(void) const
+void Record::to_upper(void)
+{
+  FASTX::to_upper(&_seq[0], _seq.size());
+}
+
+void Record::to_lower(void)
+{
+  FASTX::to_lower(&_seq[0], _seq.size());
+}
+
+void Record::hard_mask(char mask)
+{
+  FASTX::hard_mask(&_seq[0], _seq.size(), mask);
+}
+
+void Record::mask_ambiguous(char mask)
 {
-  bool ret = true;
-  // FASTQ
-  if (_type & FASTQ_TYPE)
-  {
-    if (_qual.size() != _seq.size())
-    {
-      throw std::runtime_error("Qual and sequence are not the same "
-                               "length for: " + _id);
-      ret = false;
-    }
-  }
-  if ((_type & DNA_SEQTYPE) || (_type & RNA_SEQTYPE))
-  {
-    for (char c : _seq)
-    {
-      if (global.nuc_alphabet.find(c) == global.nuc_alphabet.end())
-      {
-        std::string errmsg = "Unknown character ";
-        errmsg += c;
-        throw std::runtime_error(errmsg + " in sequence: " + _id);
-        ret = false;
-      }
-    }
-  }
   if (_type & AA_SEQTYPE)
+    throw std::runtime_error("Cannot mask ambiguous bases in amino acids");
+  FASTX::mask_ambiguous(&_seq[0], _seq.size(), mask, _type & RNA_SEQTYPE);
+}
+
+bool Record::validate(ValidationPolicy policy) const
+{
+  switch (policy)
   {
-    for (char c : _seq)
-    {
-      if (global.aa_alphabet.find(c) == global.aa_alphabet.end())
-      {
-        throw std::runtime_error("Unknown character " + std::to_string(c) +
-                                 " in sequence: " + _id);
-        ret = false;
-      }
-    }
-  }
-  if (_type & FASTQ_TYPE)
-  {
-    for (char c : _qual)
-    {
-      if (c < 33 || c > 104)
-      {
-        throw std::runtime_error("Impossible quality score " +
-                                 std::to_string(c) + " in sequence: " + _id);
-        ret = false;
-      }
-    }
+  case ValidationPolicy::NONE:
+    break;
+  case ValidationPolicy::STRUCTURAL:
+    check<ValidationPolicy::STRUCTURAL>();
+    break;
+  case ValidationPolicy::ALPHABET:
+    check<ValidationPolicy::ALPHABET>();
+    break;
+  case ValidationPolicy::FULL:
+    check<ValidationPolicy::FULL>();
+    break;
   }
-  return ret;
+  return true;
 }
 
 //Print output
@@ -213,49 +253,81 @@ std::vector<unsigned short> Record::get_numeric_qual(void) const
   if (_type & FASTA_TYPE)
     throw std::runtime_error("FASTA files do not have quality values");
 #endif
-  std::vector<unsigned short> ret;
-  for (unsigned char c : _qual)
-    ret.push_back(c);
-  return (ret);
+  const unsigned char * q = reinterpret_cast<const unsigned char*>(_qual.data());
+  return std::vector<unsigned short>(q, q + _qual.size());
+}
+
+uint64_t Record::qual_sum(unsigned short offset) const
+{
+  // Checks the type and that no score is negative
+  qual_min(offset);
+  return FASTX::qual_sum(_qual.data(), _qual.size()) -
+         static_cast<uint64_t>(offset) * _qual.size();
+}
+
+double Record::qual_mean(unsigned short offset) const
+{
+#ifndef NO_ERROR_CHECKING
+  if (_type & FASTA_TYPE)
+    throw std::runtime_error("FASTA files do not have quality values");
+#endif
+  if (_qual.empty())
+    return 0;
+  return static_cast<double>(qual_sum(offset)) / _qual.size();
+}
+
+unsigned short Record::qual_min(unsigned short offset) const
+{
+#ifndef NO_ERROR_CHECKING
+  if (_type & FASTA_TYPE)
+    throw std::runtime_error("FASTA files do not have quality values");
+#endif
+  if (_qual.empty())
+    return 0;
+  unsigned short ret = FASTX::qual_min(_qual.data(), _qual.size());
+#ifndef NO_ERROR_CHECKING
+  if (ret < offset)
+    throw std::runtime_error("Quality character " + std::to_string(ret) +
+                             " is below the PHRED offset " +
+                             std::to_string(offset) + " in sequence: " + _id);
+#endif
+  return ret > offset ? ret - offset : 0;
+}
+
+length_t Record::qual_below(unsigned short threshold,
+                            unsigned short offset) const
+{
+#ifndef NO_ERROR_CHECKING
+  if (_type & FASTA_TYPE)
+    throw std::runtime_error("FASTA files do not have quality values");
+#endif
+  unsigned short t = threshold + offset;
+  return FASTX::qual_count_below(_qual.data(), _qual.size(),
+                                 t > 255 ? 255 : t);
+}
+
+double Record::expected_errors(unsigned short offset) const
+{
+#ifndef NO_ERROR_CHECKING
+  if (_type & FASTA_TYPE)
+    throw std::runtime_error("FASTA files do not have quality values");
+#endif
+  return FASTX::expected_errors(_qual.data(), _qual.size(), offset);
 }
 
 // Translate DNA/RNA to protein
-Record Record::translate(unsigned short frame)
+Record Record::translate(unsigned short frame, unsigned short table) const
 {
 #ifndef NO_ERROR_CHECKING
   if (_type & AA_SEQTYPE)
     throw std::runtime_error("Cannot translate amino acid sequence");
 #endif
-  auto& translation_table = _type & DNA_SEQTYPE ? global.codon_to_protein_dna :
-                            global.codon_to_protein_rna;
-  std::stringstream ss(_seq);
-  std::string res;
-  ss.ignore(frame, EOF);
-  unsigned short count = 0;
-  std::string tmp;
-  while (ss.good())
-  {
-    if (count == 3)
-    {
-      count = 0;
-      auto target = translation_table.find(tmp);
-      if (target == translation_table.end())
-      {
-        res += 'X';
-      }
-      else
-      {
-        res += target->second;
-      }
-      tmp.clear();
-    }
-    tmp += ss.get();
-    count++;
-  }
+  std::string res = Translator::get(table).translate(_seq.data(), _seq.size(),
+                                                     frame);
   return Record(res, _id + " ORF" + std::to_string(frame), AA_SEQTYPE);
 }
 
-std::vector<Record>  Record::translate(void)
+std::vector<Record>  Record::translate(void) const
 {
   std::vector<Record> res;
   res.push_back( this->translate(0) );
@@ -264,20 +336,117 @@ std::vector<Record>  Record::translate(void)
   return res;
 }
 
+std::vector<Record> Record::translate_six_frame(unsigned short table) const
+{
+#ifndef NO_ERROR_CHECKING
+  if (_type & AA_SEQTYPE)
+    throw std::runtime_error("Cannot translate amino acid sequence");
+#endif
+  std::array<std::string, 6> frames;
+  Translator::get(table).six_frame(_seq.data(), _seq.size(), frames);
+  std::vector<Record> res;
+  res.reserve(6);
+  for (unsigned short f = 0; f < 6; f++)
+  {
+    std::string id = _id + (f < 3 ? " ORF" : " RC ORF") +
+                     std::to_string(f % 3);
+    res.push_back(Record(frames[f], id, AA_SEQTYPE));
+  }
+  return res;
+}
+
 // Extract a subsequence
 Record Record::subseq(length_t start, length_t stop) const
 {
-  std::string seq = _seq.substr(start, (stop - start) + 1);
-  std::string qual;
-  if (_type & FASTQ_TYPE)
-    qual = _qual.substr(start, (stop - start) + 1);
-  std::string id = _id + " " + std::to_string(start) + "-" +
-                   std::to_string(stop);
+  return RecordView(*this, start, stop).to_record();
+}
 
-  if (_type & FASTA_TYPE)
-    return Record(seq, id);
-  else
-    return Record(seq, id, qual);
+// View a subsequence without copying
+RecordView Record::subseq_view(length_t start, length_t stop) const
+{
+  return RecordView(*this, start, stop);
+}
+
+RecordView::RecordView(const Record& parent) :
+  _parent(&parent), _start(0), _stop(0), _len(parent.size()),
+  _annotate(false)
+{
+}
+
+RecordView::RecordView(const Record& parent, length_t start,
+                       length_t stop) :
+  _parent(&parent), _start(start), _stop(stop), _annotate(true)
+{
+#ifndef NO_ERROR_CHECKING
+  if (start > parent.size())
+    throw std::out_of_range("Subsequence start beyond the end of " +
+                            parent.get_id());
+#endif
+  length_t end = stop < parent.size() ? stop + 1 : parent.size();
+  _len = end > start ? end - start : 0;
+}
+
+std::string RecordView::get_qual(void) const
+{
+  if (_parent->_type & FASTQ_TYPE)
+    return std::string(qual(), _len);
+  return std::string();
+}
+
+std::string RecordView::get_id(void) const
+{
+  if (_region)
+  {
+    std::ostringstream out;
+    write_id(out);
+    return out.str();
+  }
+  if (! _annotate)
+    return _parent->_id;
+  return _parent->_id + " " + std::to_string(_start) + "-" +
+    std::to_string(_stop);
+}
+
+std::ostream& RecordView::write_id(std::ostream& outstream) const
+{
+  if (_region)
+  {
+    outstream << _parent->get_name() << ':' << _start + 1 << '-'
+              << _start + _len;
+    header_field_t comment = _parent->get_comment();
+    if (! comment.empty())
+      outstream << ' ' << comment;
+    return outstream;
+  }
+  outstream << _parent->_id;
+  if (_annotate)
+    outstream << ' ' << _start << '-' << _stop;
+  return outstream;
+}
+
+Record RecordView::to_record(void) const
+{
+  char seqtype = _parent->_type & (DNA_SEQTYPE | RNA_SEQTYPE | AA_SEQTYPE);
+  if (_parent->_type & FASTQ_TYPE)
+    return Record(get_seq(), get_id(), get_qual(), seqtype);
+  return Record(get_seq(), get_id(), seqtype);
+}
+
+std::ostream& operator<<(std::ostream& outstream, const RecordView& view)
+{
+  if (view.get_type() & FASTQ_TYPE)
+  {
+    view.write_id(outstream << '@') << '\n';
+    outstream.write(view.data(), view.size());
+    outstream << "\n+\n";
+    outstream.write(view.qual(), view.size());
+  }
+  if (view.get_type() & FASTA_TYPE)
+  {
+    view.write_id(outstream << '>') << '\n';
+    outstream.write(view.data(), view.size());
+  }
+  return outstream;
 }
 
 // Create kmers along a sequence
@@ -312,13 +481,29 @@ std::vector<Record> Record::window(length_t width, length_t increment,
 }
 
 // Get nucleotide frequency of a record
-NucFrequency Record::count_freq(void)
+NucFrequency Record::count_freq(void) const
 {
   NucFrequency ret;
   ret.add(_seq);
   return ret;
 }
 
+// Trim in place to [start, end)
+void Record::trim(length_t start, length_t end)
+{
+#ifndef NO_ERROR_CHECKING
+  if (start > end || end > _seq.size())
+    throw std::out_of_range("Invalid trim coordinates for: " + _id);
+#endif
+  _seq.erase(end);
+  _seq.erase(0, start);
+  if (_type & FASTQ_TYPE)
+  {
+    _qual.erase(end);
+    _qual.erase(0, start);
+  }
+}
+
 // Reverse complement
 Record Record::rc() const
 {
@@ -341,57 +526,76 @@ Record Record::rc() const
 std::set<Record> Record::enumerate_iupac(void)
 {
   std::set<Record> res;
-  if (this->_type & DNA_SEQTYPE)
+  if (! (_type & (DNA_SEQTYPE | RNA_SEQTYPE)))
+    return res;
+  char seqtype = _type & DNA_SEQTYPE ? DNA_SEQTYPE : RNA_SEQTYPE;
+  for (iupac_enumerator it(*this); ! it.end(); ++it)
   {
-    std::set<char> unambiguous_nuc = {'A', 'C', 'G', 'T'};
-    recursive_iupac_enum(res, *this, global.enum_iupac_dna, unambiguous_nuc);
-  }
-  else if (this->_type & RNA_SEQTYPE)
-  {
-    std::set<char> unambiguous_nuc = {'A', 'C', 'G', 'U'};
-    recursive_iupac_enum(res, *this, global.enum_iupac_rna, unambiguous_nuc);
+    if (_type & FASTQ_TYPE)
+      res.emplace(*it, _id + it.suffix(), _qual, seqtype);
+    else
+      res.emplace(*it, _id + it.suffix(), seqtype);
   }
   return res;
 }
 
-Wrap::Wrap(const Record& rec)
+uint64_t Record::count_iupac(void) const
+{
+#ifndef NO_ERROR_CHECKING
+  if (_type & AA_SEQTYPE)
+    throw std::runtime_error("Cannot enumerate amino acid record");
+#endif
+  return iupac_enumerator::count(_seq.data(), _seq.size());
+}
+
+Wrap::Wrap(const Record& rec) :
+  Wrap(rec, 80)
+{
+}
+
+Wrap::Wrap(const Record& rec, unsigned int width) :
+  _owned(std::make_shared<const Record>(rec)), _rec(*_owned), _width(width)
 {
 #ifndef NO_ERROR_CHECKING
   if (rec._type & FASTQ_TYPE)
     throw std::runtime_error("Cannot line-wrap a FASTQ record.");
 #endif
-  _id = std::make_shared<const std::string>(rec._id);
-  _seq = std::make_shared<const std::string>(rec._seq);
 }
 
-Wrap::Wrap(const Record& rec, unsigned int width)
+Wrap::Wrap(const RecordView& rec, unsigned int width) :
+  _rec(rec), _width(width)
 {
 #ifndef NO_ERROR_CHECKING
-  if (rec._type & FASTQ_TYPE)
+  if (rec.get_type() & FASTQ_TYPE)
     throw std::runtime_error("Cannot line-wrap a FASTQ record.");
 #endif
-  _id = std::make_shared<const std::string>(rec._id);
-  _seq = std::make_shared<const std::string>(rec._seq);
-  _width = width;
 }
 
 //Print wrapping at N chars
 std::ostream& Wrap::operator()(std::ostream& outstream) const
 {
-  outstream << '>' << *_id << '\n';
-  unsigned short count = 0;
-  size_t len = _seq->length();
+  _rec.write_id(outstream << '>') << '\n';
+  return write_seq(outstream);
+}
+
+// Write whole lines at once. A single base left for the last line is
+// appended to the line before.
+std::ostream& Wrap::write_seq(std::ostream& outstream) const
+{
+  const char * seq = _rec.data();
+  size_t len = _rec.size();
+  if (_width == 0)
+    return outstream.write(seq, len);
   size_t pos = 0;
-  for (char c : *_seq)
-  {
-    if (count == _width && pos != (len - 1) )
-    {
+  while (pos < len)
+  {
+    size_t n = len - pos < _width ? len - pos : _width;
+    if (len - pos - n == 1)
+      n++;
+    outstream.write(seq + pos, n);
+    pos += n;
+    if (pos < len)
       outstream << '\n';
-      count = 0;
-    }
-    outstream << c;
-    count++;
-    pos++;
   }
   return outstream;
 }
@@ -2,6 +2,7 @@
 #define _FASTX_IO_RECORD_H_
 
 #include <string>
+#include <cstdint>
 #include <memory>
 #include <fstream>
 #include <set>
@@ -10,10 +11,13 @@
 #include <matrix.h>
 #include <fastxio_common.h>
 #include <fastxio_nuc_frequency.h>
+#include <fastxio_header.h>
 #include <str_manip.h>
 
 namespace FASTX {
 
+class RecordView;
+
 /**
  * @brief General purpose FASTA and FASTQ input class.
  *
@@ -64,6 +68,45 @@ public:
     return BS::str_split_np(_id)[0];
   }
 
+  /**
+   * @brief Get the name, the ID up to the first whitespace or non printing
+   * character, without copying.
+   *
+   * @return A view of the name, valid until the ID changes.
+   */
+  header_field_t get_name(void) const {
+    header_field_t f;
+    f.data = _id.data();
+    f.size = header_name_length(_id.data(), _id.size());
+    return f;
+  }
+
+  /**
+   * @brief Get the comment, the part of the ID after the name.
+   *
+   * @return A view of the comment, empty if there is none.
+   */
+  header_field_t get_comment(void) const {
+    length_t start = header_comment_start(
+      _id.data(), _id.size(), header_name_length(_id.data(), _id.size()));
+    header_field_t f;
+    f.data = _id.data() + start;
+    f.size = _id.size() - start;
+    return f;
+  }
+
+  /**
+   * @brief Parse the ID as an Illumina read header.
+   *
+   * See `illumina_header_t` for the recognized formats.
+   *
+   * @param h Set to the parsed fields, pointing into the ID
+   * @return False if the ID is not an Illumina header
+   */
+  bool parse_illumina(illumina_header_t& h) const {
+    return FASTX::parse_illumina(get_name(), get_comment(), h);
+  }
+
   /**
    * @brief Get the type of the record.
    *
@@ -124,15 +167,21 @@ public:
   friend std::ostream& operator<<(std::ostream& outstream, const Record& rec);
 
   friend class Wrap;
+  friend class RecordView;
   friend class NucFrequency;
 
   /**
    * @brief Constructor from an istream.
    *
+   * Every validation policy is parsed by its own specialized loop, so
+   * cheaper policies do not pay for the checks they skip.
+   *
    * @param input An std::istream derived source to read from
    * @param seqtype The sequence type (macro), DNA_SEQTYPE, RNA_SEQTYPE, AA_SEQTYPE
+   * @param policy The amount of validation to perform
    */
-  Record(std::istream& input, char seqtype);
+  Record(std::istream& input, char seqtype,
+         ValidationPolicy policy = default_validation);
 
   /**
    * @brief Constructor (FASTA) from sequence and ID.
@@ -140,9 +189,10 @@ public:
    * @param fasta The sequence for the record
    * @param id The ID for the record
    * @param seqtype The sequence type (macro), DNA_SEQTYPE, RNA_SEQTYPE, AA_SEQTYPE
+   * @param policy The amount of validation to perform
    */
   Record(const std::string& fasta, const std::string& id,
-         char seqtype);
+         char seqtype, ValidationPolicy policy = default_validation);
 
   /**
    * @brief Constructor (FASTQ) from sequence, ID and qual.
@@ -151,9 +201,24 @@ public:
    * @param id The ID for the record
    * @param qual The quality string
    * @param seqtype The sequence type (macro), DNA_SEQTYPE, RNA_SEQTYPE, AA_SEQTYPE
+   * @param policy The amount of validation to perform
    */
   Record(const std::string& fastq, const std::string& id,
-         const std::string& qual, char seqtype);
+         const std::string& qual, char seqtype,
+         ValidationPolicy policy = default_validation);
+
+  /**
+   * @brief Read the next record from an istream, replacing the content.
+   *
+   * Unlike the istream constructor, this method reuses the memory of the
+   * record, which avoids allocations when reading many records.
+   *
+   * @param input An std::istream derived source to read from
+   * @param seqtype The sequence type (macro), DNA_SEQTYPE, RNA_SEQTYPE, AA_SEQTYPE
+   * @param policy The amount of validation to perform
+   */
+  void read(std::istream& input, char seqtype,
+            ValidationPolicy policy = default_validation);
 
   /**
    * @brief Empty constructor.
@@ -177,13 +242,46 @@ public:
    */
   void to_dna(void);
 
+  /**
+   * @brief Convert the sequence to uppercase.
+   *
+   */
+  void to_upper(void);
+
+  /**
+   * @brief Convert the sequence to lowercase.
+   *
+   */
+  void to_lower(void);
+
+  /**
+   * @brief Replace soft-masked (lowercase) bases.
+   *
+   * @param mask The character that replaces lowercase bases
+   */
+  void hard_mask(char mask = 'N');
+
+  /**
+   * @brief Replace all ambiguous IUPAC codes and gaps.
+   *
+   * Everything but A, C, G and T (U for RNA records) is replaced, the
+   * case of kept bases is retained.
+   *
+   * @param mask The replacement character
+   */
+  void mask_ambiguous(char mask = 'N');
+
   /**
    * @brief Translate a record to an AA record, one ORF.
    *
+   * Stop codons are translated to `*`, ambiguous codons to `X` unless all
+   * possibilities code for the same amino acid. See `Translator`.
+   *
    * @param orf The open reading frame: 0 for the first base, 1 or 2 for the next
+   * @param table The NCBI genetic code table ID
    * @return A translated (FASTA) record
    */
-  Record translate(unsigned short orf);
+  Record translate(unsigned short orf, unsigned short table = 1) const;
 
   /**
    * @brief Translate a record to an AA record, all ORFs.
@@ -192,14 +290,25 @@ public:
    *
    * @return A vector of all translated ORFs.
    */
-  std::vector<Record> translate(void);
+  std::vector<Record> translate(void) const;
+
+  /**
+   * @brief Translate all six reading frames in a single pass.
+   *
+   * The first three records are the forward ORFs 0-2, the last three
+   * the ORFs 0-2 of the reverse complement (ID suffix " RC ORF0" etc.).
+   *
+   * @param table The NCBI genetic code table ID
+   * @return A vector of six translated records.
+   */
+  std::vector<Record> translate_six_frame(unsigned short table = 1) const;
 
   /**
    * @brief Tabulate all nucleotides and get the frequencies.
    *
    * @return A class containing nucleotide frequencies.
    */
-  NucFrequency count_freq(void);
+  NucFrequency count_freq(void) const;
 
   /**
    * @brief Get a sub-sequence.
@@ -210,6 +319,31 @@ public:
    */
   Record subseq(length_t start, length_t stop) const;
 
+  /**
+   * @brief Get a sub-sequence without copying it.
+   *
+   * The view only holds a pointer to this record and the coordinates,
+   * the ID annotation ("ID start-stop", as for `subseq()`) is written
+   * when the view is printed. The record must outlive the view and must
+   * not be modified while it is in use.
+   *
+   * @param start The (0-offset) start position of the subsequence (inclusive).
+   * @param stop The stop position (inclusive).
+   * @return A view of the subsequence.
+   */
+  RecordView subseq_view(length_t start, length_t stop) const;
+
+  /**
+   * @brief Trim the record in place.
+   *
+   * Sequence and quality are cut down to [start, end) without
+   * reallocating. The ID is not changed.
+   *
+   * @param start The (0-offset) first position to keep.
+   * @param end The position after the last position to keep.
+   */
+  void trim(length_t start, length_t end);
+
   /**
    * @brief Reverse complement a record.
    *
@@ -250,15 +384,73 @@ public:
    */
   std::vector<unsigned short> get_numeric_qual(void) const;
 
+  /**
+   * @brief Sum of the PHRED quality scores.
+   *
+   * Throws if a quality character is below the offset.
+   *
+   * @param offset The PHRED offset, see `scan_phred()`
+   * @return The sum of all quality scores
+   */
+  uint64_t qual_sum(unsigned short offset = 33) const;
+
+  /**
+   * @brief Mean PHRED quality score.
+   *
+   * @param offset The PHRED offset, see `scan_phred()`
+   * @return The mean quality score, 0 for an empty record
+   */
+  double qual_mean(unsigned short offset = 33) const;
+
+  /**
+   * @brief Lowest PHRED quality score.
+   *
+   * Throws if a quality character is below the offset.
+   *
+   * @param offset The PHRED offset, see `scan_phred()`
+   * @return The lowest quality score, 0 for an empty record
+   */
+  unsigned short qual_min(unsigned short offset = 33) const;
+
+  /**
+   * @brief Count bases with a PHRED quality score below a threshold.
+   *
+   * @param threshold The quality score threshold (exclusive)
+   * @param offset The PHRED offset, see `scan_phred()`
+   * @return The number of bases with a score below `threshold`
+   */
+  length_t qual_below(unsigned short threshold,
+                      unsigned short offset = 33) const;
+
+  /**
+   * @brief Expected number of sequencing errors in the record.
+   *
+   * This is the sum of the error probabilities 10^(-Q/10) of all bases.
+   *
+   * @param offset The PHRED offset, see `scan_phred()`
+   * @return The expected number of errors
+   */
+  double expected_errors(unsigned short offset = 33) const;
+
   /**
    * @brief Enumerate all possible sequences from ambiguous IUPAC sequences
    *
+   * The IDs of the expansions carry the chosen bases, e.g. `ID_5A_9T`.
+   * All expansions are held in memory, see `iupac_enumerator` to generate
+   * them one by one and `count_iupac()` to check their number first.
    * See also the `enumerate_iupac` example.
    *
    * @return A set of all possible unambiguous sequences
    */
   std::set<Record> enumerate_iupac(void);
 
+  /**
+   * @brief Number of sequences an ambiguous IUPAC sequence stands for
+   *
+   * @return The number of expansions, UINT64_MAX if it does not fit
+   */
+  uint64_t count_iupac(void) const;
+
   /**
    * @brief Validate the record.
    *
@@ -266,9 +458,10 @@ public:
    * the quality values cannot be outside the allowed range,
    * the sequence is tested for disallowed characters.
    *
+   * @param policy The amount of validation to perform
    * @return True, if the record is valid, false otherwise
    */
-  bool validate(void) const;
+  bool validate(ValidationPolicy policy = ValidationPolicy::FULL) const;
 
   /**
    * @brief Comparison less than operator for `Record` classes.
@@ -375,6 +568,9 @@ public:
   friend class MinHash;
 
 private:
+  template <ValidationPolicy P> void parse(std::istream& input, char seqtype);
+  template <ValidationPolicy P> void check(void) const;
+
   std::string _seq;
   std::string _qual;
   std::string _id;
@@ -448,6 +644,133 @@ inline bool operator <=(const Record& a, const Record& b)
   return a._seq <= b._seq;
 }
 
+/**
+ * @brief A non-owning sub-sequence of a `Record`
+ *
+ * Created by `Record::subseq_view()`. Sequence and quality point into the
+ * parent record, no strings are copied or built until the view is
+ * printed or converted with `to_record()`. A view constructed from a
+ * whole record keeps the parent ID as it is.
+ */
+class RecordView
+{
+public:
+  /**
+   * @brief Constructor on a whole record
+   *
+   * @param parent The record
+   */
+  RecordView(const Record& parent);
+
+  /**
+   * @brief Constructor on a sub-sequence
+   *
+   * As with `Record::subseq()`, a stop past the end of the record is
+   * clipped to the last position, the ID annotation keeps it as given.
+   *
+   * @param parent The record
+   * @param start The (0-offset) start position (inclusive)
+   * @param stop The stop position (inclusive)
+   */
+  RecordView(const Record& parent, length_t start, length_t stop);
+
+  /**
+   * @brief The record the view points into
+   */
+  const Record& parent(void) const { return *_parent; }
+
+  /**
+   * @brief Pointer to the first base of the view
+   */
+  const char * data(void) const { return _parent->_seq.data() + _start; }
+
+  /**
+   * @brief Pointer to the first quality value, nullptr for FASTA records
+   */
+  const char * qual(void) const {
+    return _parent->_type & FASTQ_TYPE ? _parent->_qual.data() + _start :
+      nullptr;
+  }
+
+  /**
+   * @brief Length of the view
+   */
+  length_t size(void) const { return _len; }
+
+  /**
+   * @brief The (0-offset) start position in the parent
+   */
+  length_t start(void) const { return _start; }
+
+  /**
+   * @brief The type of the parent, see `Record::get_type()`
+   */
+  char get_type(void) const { return _parent->_type; }
+
+  /**
+   * @brief Copy of the sequence
+   */
+  std::string get_seq(void) const { return std::string(data(), _len); }
+
+  /**
+   * @brief Copy of the quality string, empty for FASTA records
+   */
+  std::string get_qual(void) const;
+
+  /**
+   * @brief The ID, including the coordinate annotation
+   */
+  std::string get_id(void) const;
+
+  /**
+   * @brief Write the ID, including the coordinate annotation
+   *
+   * @param outstream The output stream
+   */
+  std::ostream& write_id(std::ostream& outstream) const;
+
+  /**
+   * @brief Annotate the ID as a region instead
+   *
+   * The ID becomes "name:start-end comment", with 1-based, inclusive
+   * coordinates as used by e.g. `samtools faidx`, so views of one record
+   * get distinct names.
+   *
+   * @return This view
+   */
+  RecordView& as_region(void) { _region = true; return *this; }
+
+  /**
+   * @brief Create an independent record, same as `Record::subseq()`
+   */
+  Record to_record(void) const;
+
+  /**
+   * @brief Print the view to a sink as a FASTA or FASTQ record
+   *
+   * @param outstream A sink to print to.
+   * @param view A record view
+   */
+  friend std::ostream& operator<<(std::ostream& outstream,
+                                  const RecordView& view);
+
+private:
+  const Record * _parent;
+  length_t _start;
+  length_t _stop;  // As given, for the annotation
+  length_t _len;
+  bool _annotate;
+  bool _region = false;
+};
+
+/**
+ * @brief Print a record view to a sink.
+ *
+ * @param outstream A sink to print to.
+ * @param view A record view
+ */
+std::ostream& operator<<(std::ostream& outstream, const RecordView& view);
+
 /**
  * @brief Helper class to wrap FASTA when printing
  *
@@ -465,6 +788,8 @@ public:
   /**
    * @brief Constructor from const Record
    *
+   * The record is copied, so it may be a temporary.
+   *
    * @param rec A record object
    */
   Wrap(const Record& rec);
@@ -472,11 +797,23 @@ public:
   /**
    * @brief Constructor from const Record with specified width
    *
+   * The record is copied, so it may be a temporary.
+   *
    * @param rec A record object
    * @param width The column width (Default: 80)
    */
   Wrap(const Record& rec, unsigned int width);
 
+  /**
+   * @brief Constructor from a record view, e.g. of `Record::subseq_view()`
+   *
+   * Nothing is copied, the record of the view must outlive the Wrap object.
+   *
+   * @param rec A record view
+   * @param width The column width (Default: 80)
+   */
+  Wrap(const RecordView& rec, unsigned int width = 80);
+
   /**
    * @brief Overload of operator() to handle formatting and passing to an std::ostream
    *
@@ -486,6 +823,15 @@ public:
    */
   std::ostream& operator()(std::ostream& outstream) const;
 
+  /**
+   * @brief Write only the wrapped sequence lines, without the header
+   *
+   * This allows to write a custom header before the sequence.
+   *
+   * @param outstream The output stream
+   */
+  std::ostream& write_seq(std::ostream& outstream) const;
+
   /**
    * @brief Overloaded operator<< to print to an ostream
    *
@@ -495,8 +841,9 @@ public:
   friend std::ostream& operator<<(std::ostream& outstream, Wrap rec);
 
 private:
-  std::shared_ptr<const std::string> _id;
-  std::shared_ptr<const std::string> _seq;
+  // Copy of the record for the Record constructors, _rec points into it
+  std::shared_ptr<const Record> _owned;
+  RecordView _rec;
   unsigned int _width = 80;
 
   /**
@@ -531,7 +878,9 @@ std::ostream& operator<<(std::ostream& outstream, Wrap rec);
  *
  * For large numbers of kmers the `kmer()` method of the `Record` class
  * can be quite memory intensive. This class provides an 'iterator-like'
- * helper that constructs kmers on the fly.
+ * helper that constructs kmers on the fly. If only the k-mer sequences
+ * are needed (e.g. for counting or hashing), `kmer_iterator` is much
+ * faster as it does not create records.
  */
 class kmer_walker
 {
@@ -663,7 +1012,8 @@ private:
  *
  * For large numbers of windows the `window()` method of the `Record` class
  * can be quite memory intensive. This class provides an 'iterator-like'
- * helper that constructs windows on the fly.
+ * helper that constructs windows on the fly. `window_iterator` avoids the
+ * copies altogether and keeps running base counts of the window.
  */
 class window_walker
 {
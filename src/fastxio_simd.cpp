@@ -0,0 +1,523 @@
+#include <cstdint>
+#include <cmath>
+#include <array>
+#include <cstring>
+#include <fastxio_common.h>
+#include <fastxio_simd.h>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace FASTX {
+
+extern GData global; /**< Global variable of translation tables */
+
+namespace {
+
+// Byte classes that are allowed for a sequence type
+unsigned char seqtype_class(char seqtype)
+{
+  unsigned char ret = 0;
+  if ((seqtype & DNA_SEQTYPE) || (seqtype & RNA_SEQTYPE))
+    ret |= NUC_CHARCLASS;
+  if (seqtype & AA_SEQTYPE)
+    ret |= AA_CHARCLASS;
+  return ret;
+}
+
+#if defined(__SSSE3__)
+// Nibble lookup tables of a byte class. A character c is part of the class
+// if (lo[c & 0xf] & hi[c >> 4]) != 0. Every high nibble of printable ASCII
+// (2-7) gets its own bit, all others map to zero.
+struct nibble_lut_t
+{
+  unsigned char lo[16];
+  unsigned char hi[16];
+};
+
+nibble_lut_t make_nibble_lut(unsigned char charclass)
+{
+  nibble_lut_t ret = {};
+  for (unsigned h = 2; h < 8; h++)
+  {
+    unsigned char bit = 1 << (h - 2);
+    ret.hi[h] = bit;
+    for (unsigned l = 0; l < 16; l++)
+    {
+      if (global.char_class[(h << 4) | l] & charclass)
+        ret.lo[l] |= bit;
+    }
+  }
+  return ret;
+}
+
+const nibble_lut_t& nibble_lut(unsigned char charclass)
+{
+  static const nibble_lut_t luts[4] = {
+    make_nibble_lut(0),
+    make_nibble_lut(NUC_CHARCLASS),
+    make_nibble_lut(AA_CHARCLASS),
+    make_nibble_lut(NUC_CHARCLASS | AA_CHARCLASS)
+  };
+  return luts[charclass & 3];
+}
+
+// Bitmask of bytes in v that are not part of the class
+inline uint32_t invalid_mask(__m128i v, __m128i lo_lut, __m128i hi_lut)
+{
+  const __m128i nibble = _mm_set1_epi8(0x0f);
+  __m128i lo = _mm_and_si128(v, nibble);
+  __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+  __m128i hit = _mm_and_si128(_mm_shuffle_epi8(lo_lut, lo),
+                              _mm_shuffle_epi8(hi_lut, hi));
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(hit, _mm_setzero_si128()));
+}
+#endif
+
+#if defined(__AVX2__)
+inline uint32_t invalid_mask(__m256i v, __m256i lo_lut, __m256i hi_lut)
+{
+  const __m256i nibble = _mm256_set1_epi8(0x0f);
+  __m256i lo = _mm256_and_si256(v, nibble);
+  __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+  __m256i hit = _mm256_and_si256(_mm256_shuffle_epi8(lo_lut, lo),
+                                 _mm256_shuffle_epi8(hi_lut, hi));
+  return _mm256_movemask_epi8(_mm256_cmpeq_epi8(hit, _mm256_setzero_si256()));
+}
+#endif
+
+#if defined(__SSE2__)
+// Byte mask of v in [lo, hi], only valid for ASCII bounds
+inline __m128i in_range(__m128i v, char lo, char hi)
+{
+  return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)),
+                       _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1)));
+}
+
+// Take a where m is set, b otherwise
+inline __m128i select(__m128i m, __m128i a, __m128i b)
+{
+  return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b));
+}
+#endif
+
+// In place transformations. Each functor maps one byte, and 16 bytes at a
+// time if SSE2 is available.
+struct upper_op
+{
+  char operator()(char c) const {
+    return (c >= 'a' && c <= 'z') ? c - 0x20 : c;
+  }
+#if defined(__SSE2__)
+  __m128i operator()(__m128i v) const {
+    return _mm_sub_epi8(v, _mm_and_si128(in_range(v, 'a', 'z'),
+                                         _mm_set1_epi8(0x20)));
+  }
+#endif
+};
+
+struct lower_op
+{
+  char operator()(char c) const {
+    return (c >= 'A' && c <= 'Z') ? c + 0x20 : c;
+  }
+#if defined(__SSE2__)
+  __m128i operator()(__m128i v) const {
+    return _mm_add_epi8(v, _mm_and_si128(in_range(v, 'A', 'Z'),
+                                         _mm_set1_epi8(0x20)));
+  }
+#endif
+};
+
+// T <-> U and t <-> u differ only in the lowest bit
+struct swap_base_op
+{
+  char from;
+  char operator()(char c) const {
+    return (c == from || c == (from | 0x20)) ? c ^ 1 : c;
+  }
+#if defined(__SSE2__)
+  __m128i operator()(__m128i v) const {
+    __m128i hit = _mm_cmpeq_epi8(_mm_or_si128(v, _mm_set1_epi8(0x20)),
+                                 _mm_set1_epi8(from | 0x20));
+    return _mm_xor_si128(v, _mm_and_si128(hit, _mm_set1_epi8(1)));
+  }
+#endif
+};
+
+struct hard_mask_op
+{
+  char mask;
+  char operator()(char c) const {
+    return (c >= 'a' && c <= 'z') ? mask : c;
+  }
+#if defined(__SSE2__)
+  __m128i operator()(__m128i v) const {
+    return select(in_range(v, 'a', 'z'), _mm_set1_epi8(mask), v);
+  }
+#endif
+};
+
+// Letters that only differ by case are equal after setting bit 0x20
+struct mask_ambiguous_op
+{
+  char mask;
+  char fourth; // 't' or 'u'
+  char operator()(char c) const {
+    char f = c | 0x20;
+    return (f == 'a' || f == 'c' || f == 'g' || f == fourth) ? c : mask;
+  }
+#if defined(__SSE2__)
+  __m128i operator()(__m128i v) const {
+    __m128i f = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    __m128i keep = _mm_or_si128(
+                     _mm_or_si128(_mm_cmpeq_epi8(f, _mm_set1_epi8('a')),
+                                  _mm_cmpeq_epi8(f, _mm_set1_epi8('c'))),
+                     _mm_or_si128(_mm_cmpeq_epi8(f, _mm_set1_epi8('g')),
+                                  _mm_cmpeq_epi8(f, _mm_set1_epi8(fourth))));
+    return select(keep, v, _mm_set1_epi8(mask));
+  }
+#endif
+};
+
+template <typename Op>
+void transform(char * seq, length_t len, const Op& op)
+{
+  length_t i = 0;
+#if defined(__SSE2__)
+  for (; i + 16 <= len; i += 16)
+  {
+    __m128i * p = reinterpret_cast<__m128i*>(seq + i);
+    _mm_storeu_si128(p, op(_mm_loadu_si128(p)));
+  }
+#endif
+  for (; i < len; i++)
+  {
+    seq[i] = op(seq[i]);
+  }
+}
+
+// Error probability of PHRED score Q
+std::array<double, 256> make_error_prob(void)
+{
+  std::array<double, 256> ret;
+  for (unsigned q = 0; q < ret.size(); q++)
+  {
+    ret[q] = std::pow(10.0, -static_cast<double>(q) / 10.0);
+  }
+  return ret;
+}
+
+const std::array<double, 256> error_prob = make_error_prob();
+
+// Offset of the first byte that is (or is not) N/n. Setting bit 0x20 maps
+// both N and n, and only those, to 'n'.
+template <bool IS_N>
+length_t scan_n(const char * seq, length_t len)
+{
+  length_t i = 0;
+#if defined(__AVX2__)
+  const __m256i n32 = _mm256_set1_epi8('n');
+  const __m256i case32 = _mm256_set1_epi8(0x20);
+  for (; i + 32 <= len; i += 32)
+  {
+    __m256i v = _mm256_or_si256(
+                  _mm256_loadu_si256(reinterpret_cast<const __m256i*>(seq + i)),
+                  case32);
+    uint32_t hit = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, n32));
+    if (! IS_N)
+      hit = ~hit;
+    if (hit)
+      return i + __builtin_ctz(hit);
+  }
+#endif
+#if defined(__SSE2__)
+  const __m128i n16 = _mm_set1_epi8('n');
+  const __m128i case16 = _mm_set1_epi8(0x20);
+  for (; i + 16 <= len; i += 16)
+  {
+    __m128i v = _mm_or_si128(
+                  _mm_loadu_si128(reinterpret_cast<const __m128i*>(seq + i)),
+                  case16);
+    uint32_t hit = _mm_movemask_epi8(_mm_cmpeq_epi8(v, n16));
+    if (! IS_N)
+      hit = ~hit & 0xffff;
+    if (hit)
+      return i + __builtin_ctz(hit);
+  }
+#endif
+  for (; i < len; i++)
+  {
+    if (((seq[i] | 0x20) == 'n') == IS_N)
+      return i;
+  }
+  return len;
+}
+
+} // anonymous namespace
+
+length_t first_invalid_seq(const char * seq, length_t len, char seqtype)
+{
+  unsigned char charclass = seqtype_class(seqtype);
+  length_t i = 0;
+#if defined(__SSSE3__)
+  const nibble_lut_t& lut = nibble_lut(charclass);
+  const __m128i lo_lut = _mm_loadu_si128(
+                           reinterpret_cast<const __m128i*>(lut.lo));
+  const __m128i hi_lut = _mm_loadu_si128(
+                           reinterpret_cast<const __m128i*>(lut.hi));
+#if defined(__AVX2__)
+  const __m256i lo_lut2 = _mm256_broadcastsi128_si256(lo_lut);
+  const __m256i hi_lut2 = _mm256_broadcastsi128_si256(hi_lut);
+  for (; i + 64 <= len; i += 64)
+  {
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(seq + i));
+    __m256i b = _mm256_loadu_si256(
+                  reinterpret_cast<const __m256i*>(seq + i + 32));
+    uint64_t bad = invalid_mask(a, lo_lut2, hi_lut2) |
+                   (uint64_t(invalid_mask(b, lo_lut2, hi_lut2)) << 32);
+    if (bad)
+      return i + __builtin_ctzll(bad);
+  }
+#endif
+  for (; i + 16 <= len; i += 16)
+  {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(seq + i));
+    uint32_t bad = invalid_mask(v, lo_lut, hi_lut);
+    if (bad)
+      return i + __builtin_ctz(bad);
+  }
+#endif
+  for (; i < len; i++)
+  {
+    if (! (global.char_class[static_cast<unsigned char>(seq[i])] & charclass))
+      return i;
+  }
+  return len;
+}
+
+length_t first_invalid_qual(const char * qual, length_t len,
+                            unsigned char min, unsigned char max)
+{
+  length_t i = 0;
+#if defined(__SSE2__)
+  // Bias by 0x80 so that signed comparisons act as unsigned ones
+  const __m128i bias = _mm_set1_epi8(char(0x80));
+  const __m128i lo = _mm_set1_epi8(char(min ^ 0x80));
+  const __m128i hi = _mm_set1_epi8(char(max ^ 0x80));
+#if defined(__AVX2__)
+  const __m256i bias2 = _mm256_broadcastsi128_si256(bias);
+  const __m256i lo2 = _mm256_broadcastsi128_si256(lo);
+  const __m256i hi2 = _mm256_broadcastsi128_si256(hi);
+  for (; i + 32 <= len; i += 32)
+  {
+    __m256i v = _mm256_xor_si256(bias2, _mm256_loadu_si256(
+                                   reinterpret_cast<const __m256i*>(qual + i)));
+    __m256i out = _mm256_or_si256(_mm256_cmpgt_epi8(lo2, v),
+                                  _mm256_cmpgt_epi8(v, hi2));
+    uint32_t bad = _mm256_movemask_epi8(out);
+    if (bad)
+      return i + __builtin_ctz(bad);
+  }
+#endif
+  for (; i + 16 <= len; i += 16)
+  {
+    __m128i v = _mm_xor_si128(bias, _mm_loadu_si128(
+                                reinterpret_cast<const __m128i*>(qual + i)));
+    __m128i out = _mm_or_si128(_mm_cmpgt_epi8(lo, v), _mm_cmpgt_epi8(v, hi));
+    uint32_t bad = _mm_movemask_epi8(out);
+    if (bad)
+      return i + __builtin_ctz(bad);
+  }
+#endif
+  for (; i < len; i++)
+  {
+    unsigned char c = qual[i];
+    if (c < min || c > max)
+      return i;
+  }
+  return len;
+}
+
+void to_upper(char * seq, length_t len)
+{
+  transform(seq, len, upper_op());
+}
+
+void to_lower(char * seq, length_t len)
+{
+  transform(seq, len, lower_op());
+}
+
+void dna_to_rna(char * seq, length_t len)
+{
+  transform(seq, len, swap_base_op{'T'});
+}
+
+void rna_to_dna(char * seq, length_t len)
+{
+  transform(seq, len, swap_base_op{'U'});
+}
+
+void hard_mask(char * seq, length_t len, char mask)
+{
+  transform(seq, len, hard_mask_op{mask});
+}
+
+void mask_ambiguous(char * seq, length_t len, char mask, bool rna)
+{
+  transform(seq, len, mask_ambiguous_op{mask, rna ? 'u' : 't'});
+}
+
+uint64_t qual_sum(const char * qual, length_t len)
+{
+  uint64_t ret = 0;
+  length_t i = 0;
+#if defined(__SSE2__)
+  // Sum of absolute differences against zero adds up 8 bytes per lane
+  __m128i acc = _mm_setzero_si128();
+  for (; i + 16 <= len; i += 16)
+  {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(qual + i));
+    acc = _mm_add_epi64(acc, _mm_sad_epu8(v, _mm_setzero_si128()));
+  }
+  uint64_t lanes[2];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+  ret = lanes[0] + lanes[1];
+#endif
+  for (; i < len; i++)
+  {
+    ret += static_cast<unsigned char>(qual[i]);
+  }
+  return ret;
+}
+
+unsigned char qual_min(const char * qual, length_t len)
+{
+  unsigned char ret = 255;
+  length_t i = 0;
+#if defined(__SSE2__)
+  if (len >= 16)
+  {
+    __m128i acc = _mm_set1_epi8(char(255));
+    for (; i + 16 <= len; i += 16)
+    {
+      acc = _mm_min_epu8(acc, _mm_loadu_si128(
+                           reinterpret_cast<const __m128i*>(qual + i)));
+    }
+    unsigned char lanes[16];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    for (unsigned char c : lanes)
+      ret = c < ret ? c : ret;
+  }
+#endif
+  for (; i < len; i++)
+  {
+    unsigned char c = qual[i];
+    ret = c < ret ? c : ret;
+  }
+  return ret;
+}
+
+length_t qual_count_below(const char * qual, length_t len,
+                          unsigned char threshold)
+{
+  length_t ret = 0;
+  length_t i = 0;
+#if defined(__SSE2__)
+  const __m128i bias = _mm_set1_epi8(char(0x80));
+  const __m128i thr = _mm_set1_epi8(char(threshold ^ 0x80));
+  const __m128i one = _mm_set1_epi8(1);
+  __m128i acc = _mm_setzero_si128();
+  for (; i + 16 <= len; i += 16)
+  {
+    __m128i v = _mm_xor_si128(bias, _mm_loadu_si128(
+                                reinterpret_cast<const __m128i*>(qual + i)));
+    __m128i below = _mm_and_si128(_mm_cmpgt_epi8(thr, v), one);
+    acc = _mm_add_epi64(acc, _mm_sad_epu8(below, _mm_setzero_si128()));
+  }
+  uint64_t lanes[2];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+  ret = lanes[0] + lanes[1];
+#endif
+  for (; i < len; i++)
+  {
+    ret += static_cast<unsigned char>(qual[i]) < threshold;
+  }
+  return ret;
+}
+
+double expected_errors(const char * qual, length_t len, unsigned short offset)
+{
+  // Four partial sums break the dependency chain of the additions
+  double acc[4] = {0, 0, 0, 0};
+  length_t i = 0;
+  for (; i + 4 <= len; i += 4)
+  {
+    for (unsigned j = 0; j < 4; j++)
+    {
+      unsigned char c = qual[i + j];
+      acc[j] += error_prob[c > offset ? c - offset : 0];
+    }
+  }
+  for (; i < len; i++)
+  {
+    unsigned char c = qual[i];
+    acc[0] += error_prob[c > offset ? c - offset : 0];
+  }
+  return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+void byte_histogram(const char * seq, length_t len, uint64_t * counts)
+{
+  const unsigned char * s = reinterpret_cast<const unsigned char *>(seq);
+  // Clearing the sub-tables only pays off for longer buffers
+  if (len < 1024)
+  {
+    for (length_t i = 0; i < len; i++)
+      counts[s[i]]++;
+    return;
+  }
+  // Blocks are small enough for the 32-bit counters not to overflow
+  const length_t block = length_t(1) << 31;
+  uint32_t t[4][256];
+  while (len > 0)
+  {
+    length_t n = len < block ? len : block;
+    std::memset(t, 0, sizeof(t));
+    length_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+      uint64_t w;
+      std::memcpy(&w, s + i, 8);
+      t[0][w & 0xff]++;
+      t[1][(w >> 8) & 0xff]++;
+      t[2][(w >> 16) & 0xff]++;
+      t[3][(w >> 24) & 0xff]++;
+      t[0][(w >> 32) & 0xff]++;
+      t[1][(w >> 40) & 0xff]++;
+      t[2][(w >> 48) & 0xff]++;
+      t[3][w >> 56]++;
+    }
+    for (; i < n; i++)
+      t[0][s[i]]++;
+    for (unsigned c = 0; c < 256; c++)
+      counts[c] += static_cast<uint64_t>(t[0][c]) + t[1][c] + t[2][c] +
+        t[3][c];
+    s += n;
+    len -= n;
+  }
+}
+
+length_t first_n(const char * seq, length_t len)
+{
+  return scan_n<true>(seq, len);
+}
+
+length_t first_not_n(const char * seq, length_t len)
+{
+  return scan_n<false>(seq, len);
+}
+
+}
@@ -0,0 +1,176 @@
+#ifndef _FASTX_IO_SIMD_H_
+#define _FASTX_IO_SIMD_H_
+
+#include <cstdint>
+#include <fastxio_common.h>
+
+namespace FASTX {
+
+/**
+ * @brief Vectorized byte kernels
+ *
+ * The functions here operate on raw character buffers and are the
+ * building blocks of the per-record operations of the `Record` class.
+ * They use AVX2 or SSSE3/SSE2 instructions if the library was compiled
+ * with support for them (e.g. `cmake -DNATIVE_ARCH=ON`) and fall back to
+ * table driven scalar code otherwise.
+ */
+
+/**
+ * @brief Find the first character that is not part of the alphabet of a
+ * sequence type.
+ *
+ * The test is a byte class lookup in `GData::char_class`, performed on
+ * 16 or 32 bytes at a time.
+ *
+ * @param seq Pointer to the sequence
+ * @param len Length of the sequence
+ * @param seqtype The sequence type (macro) DNA_SEQTYPE, RNA_SEQTYPE or AA_SEQTYPE
+ * @return The offset of the first invalid character, or `len` if all
+ * characters are valid.
+ */
+length_t first_invalid_seq(const char * seq, length_t len, char seqtype);
+
+/**
+ * @brief Find the first quality character outside of an allowed range.
+ *
+ * @param qual Pointer to the quality string
+ * @param len Length of the quality string
+ * @param min Smallest allowed character (inclusive)
+ * @param max Largest allowed character (inclusive)
+ * @return The offset of the first invalid character, or `len` if all
+ * characters are valid.
+ */
+length_t first_invalid_qual(const char * qual, length_t len,
+                            unsigned char min = 33, unsigned char max = 104);
+
+/**
+ * @brief Convert all lowercase letters to uppercase, in place.
+ *
+ * @param seq Pointer to the sequence
+ * @param len Length of the sequence
+ */
+void to_upper(char * seq, length_t len);
+
+/**
+ * @brief Convert all uppercase letters to lowercase, in place.
+ *
+ * @param seq Pointer to the sequence
+ * @param len Length of the sequence
+ */
+void to_lower(char * seq, length_t len);
+
+/**
+ * @brief Replace T/t with U/u, in place.
+ *
+ * @param seq Pointer to the sequence
+ * @param len Length of the sequence
+ */
+void dna_to_rna(char * seq, length_t len);
+
+/**
+ * @brief Replace U/u with T/t, in place.
+ *
+ * @param seq Pointer to the sequence
+ * @param len Length of the sequence
+ */
+void rna_to_dna(char * seq, length_t len);
+
+/**
+ * @brief Hard-mask soft-masked (lowercase) letters, in place.
+ *
+ * @param seq Pointer to the sequence
+ * @param len Length of the sequence
+ * @param mask The character that replaces lowercase letters
+ */
+void hard_mask(char * seq, length_t len, char mask = 'N');
+
+/**
+ * @brief Replace everything but unambiguous nucleotides, in place.
+ *
+ * A, C, G and T (or U for RNA) are kept in either case, all other
+ * characters are replaced.
+ *
+ * @param seq Pointer to the sequence
+ * @param len Length of the sequence
+ * @param mask The replacement character
+ * @param rna Keep U instead of T
+ */
+void mask_ambiguous(char * seq, length_t len, char mask = 'N',
+                    bool rna = false);
+
+/**
+ * @brief Sum of the quality characters (including the PHRED offset).
+ *
+ * @param qual Pointer to the quality string
+ * @param len Length of the quality string
+ * @return The sum of all characters
+ */
+uint64_t qual_sum(const char * qual, length_t len);
+
+/**
+ * @brief Smallest quality character.
+ *
+ * @param qual Pointer to the quality string
+ * @param len Length of the quality string
+ * @return The smallest character, or 255 if `len` is 0
+ */
+unsigned char qual_min(const char * qual, length_t len);
+
+/**
+ * @brief Count quality characters below a threshold.
+ *
+ * @param qual Pointer to the quality string
+ * @param len Length of the quality string
+ * @param threshold The threshold character (exclusive)
+ * @return The number of characters smaller than `threshold`
+ */
+length_t qual_count_below(const char * qual, length_t len,
+                          unsigned char threshold);
+
+/**
+ * @brief Expected number of errors, the sum of 10^(-Q/10) over all bases.
+ *
+ * @param qual Pointer to the quality string
+ * @param len Length of the quality string
+ * @param offset The PHRED offset (33 or 64)
+ * @return The expected number of errors
+ */
+double expected_errors(const char * qual, length_t len,
+                       unsigned short offset = 33);
+
+/**
+ * @brief Add the byte counts of a buffer to a histogram.
+ *
+ * Long buffers are counted into four 32-bit sub-tables, eight bytes per
+ * load, so that runs of one character (poly-A, N gaps) do not serialize
+ * on a single counter. The sub-tables are summed at the end.
+ *
+ * @param seq Pointer to the buffer
+ * @param len Length of the buffer
+ * @param counts Histogram of 256 counters, indexed by unsigned byte
+ */
+void byte_histogram(const char * seq, length_t len, uint64_t * counts);
+
+/**
+ * @brief Find the first N (or n).
+ *
+ * @param seq Pointer to the sequence
+ * @param len Length of the sequence
+ * @return The offset of the first N, or `len` if there is none
+ */
+length_t first_n(const char * seq, length_t len);
+
+/**
+ * @brief Find the first character that is not N (or n), i.e. the end of
+ * an N run.
+ *
+ * @param seq Pointer to the sequence
+ * @param len Length of the sequence
+ * @return The offset of the first other character, or `len` if there is
+ * none
+ */
+length_t first_not_n(const char * seq, length_t len);
+
+}
+#endif
@@ -0,0 +1,174 @@
+#include <string>
+#include <vector>
+#include <sstream>
+#include <cstdint>
+#include <stdexcept>
+#include <fastxio_common.h>
+#include <fastxio_record.h>
+#include <fastxio_view.h>
+#include <fastxio_tracks.h>
+
+namespace FASTX {
+
+namespace {
+
+// A bedGraph interval waiting to be merged with the next one
+struct pending_t
+{
+  length_t start = 0;
+  length_t end = 0;
+  double value = 0;
+  bool open = false;
+};
+
+void flush(std::ostream& out, const std::string& chrom, pending_t& p)
+{
+  if (p.open)
+    out << chrom << '\t' << p.start << '\t' << p.end << '\t' << p.value << '\n';
+  p.open = false;
+}
+
+} // anonymous namespace
+
+CompositionTracks::CompositionTracks(length_t width, length_t step,
+                                     bool include_final) :
+  _width(width), _step(step), _include_final(include_final)
+{
+#ifndef NO_ERROR_CHECKING
+  if (width == 0 || step == 0)
+    throw std::runtime_error("Window width and step must be positive");
+#endif
+}
+
+void CompositionTracks::add(CompositionTrack track, std::ostream& out)
+{
+  _tracks.push_back(track);
+  _outs.push_back(&out);
+}
+
+bool CompositionTracks::value(CompositionTrack track,
+                              const WindowCounts& counts, double& value)
+{
+  length_t called = counts.size() - counts.n();
+  switch (track)
+  {
+  case CompositionTrack::GC:
+    if (called == 0)
+      return false;
+    value = 100.0 * counts.gc() / called;
+    return true;
+  case CompositionTrack::GC_SKEW:
+    if (counts.g() + counts.c() == 0)
+      return false;
+    value = (static_cast<double>(counts.g()) - counts.c()) /
+      (counts.g() + counts.c());
+    return true;
+  case CompositionTrack::CPG_OE:
+    if (counts.g() == 0 || counts.c() == 0)
+      return false;
+    value = static_cast<double>(counts.cpg()) * counts.size() /
+      (static_cast<double>(counts.c()) * counts.g());
+    return true;
+  case CompositionTrack::N_FRACTION:
+    if (counts.size() == 0)
+      return false;
+    value = static_cast<double>(counts.n()) / counts.size();
+    return true;
+  case CompositionTrack::SOFT_MASKED:
+    if (counts.size() == 0)
+      return false;
+    value = static_cast<double>(counts.soft_masked()) / counts.size();
+    return true;
+  }
+  return false;
+}
+
+std::string CompositionTracks::name(CompositionTrack track)
+{
+  switch (track)
+  {
+  case CompositionTrack::GC:
+    return "gc";
+  case CompositionTrack::GC_SKEW:
+    return "gc_skew";
+  case CompositionTrack::CPG_OE:
+    return "cpg_oe";
+  case CompositionTrack::N_FRACTION:
+    return "n";
+  case CompositionTrack::SOFT_MASKED:
+    return "masked";
+  }
+  return "";
+}
+
+CompositionTrack CompositionTracks::parse(const std::string& name)
+{
+  for (CompositionTrack t : {CompositionTrack::GC, CompositionTrack::GC_SKEW,
+                             CompositionTrack::CPG_OE,
+                             CompositionTrack::N_FRACTION,
+                             CompositionTrack::SOFT_MASKED})
+  {
+    if (CompositionTracks::name(t) == name)
+      return t;
+  }
+  throw std::runtime_error("Unknown composition track: " + name);
+}
+
+std::vector<std::string> CompositionTracks::bedgraph(const Record& r) const
+{
+  const std::string chrom = r.get_canonical_id();
+  std::vector<std::ostringstream> out(_tracks.size());
+  std::vector<pending_t> pending(_tracks.size());
+
+  for (window_iterator w(_width, _step, r, _include_final); ! w.end(); ++w)
+  {
+    length_t start = w.start();
+    length_t end = w.stop() < start + _step ? w.stop() : start + _step;
+    for (size_t i = 0; i < _tracks.size(); i++)
+    {
+      pending_t& p = pending[i];
+      double v;
+      if (! value(_tracks[i], w.counts(), v))
+      {
+        flush(out[i], chrom, p);
+        continue;
+      }
+      if (p.open && p.end == start && p.value == v)
+      {
+        p.end = end;
+        continue;
+      }
+      flush(out[i], chrom, p);
+      p.start = start;
+      p.end = end;
+      p.value = v;
+      p.open = true;
+    }
+  }
+
+  std::vector<std::string> ret(_tracks.size());
+  for (size_t i = 0; i < _tracks.size(); i++)
+  {
+    flush(out[i], chrom, pending[i]);
+    ret[i] = out[i].str();
+  }
+  return ret;
+}
+
+void CompositionTracks::write(const std::vector<Record>& batch)
+{
+  std::vector<std::vector<std::string>> res(batch.size());
+  int64_t n = batch.size();
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (int64_t i = 0; i < n; i++)
+  {
+    res[i] = bedgraph(batch[i]);
+  }
+  for (auto& r : res)
+  {
+    for (size_t i = 0; i < _outs.size(); i++)
+      *_outs[i] << r[i];
+  }
+}
+
+}
@@ -0,0 +1,105 @@
+#ifndef _FASTX_IO_TRACKS_H_
+#define _FASTX_IO_TRACKS_H_
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <fastxio_common.h>
+#include <fastxio_record.h>
+#include <fastxio_view.h>
+
+namespace FASTX {
+
+/**
+ * @brief Sequence composition measures of a window
+ */
+enum class CompositionTrack
+{
+  GC,         /**< G + C + S over all non-N bases, in percent */
+  GC_SKEW,    /**< (G - C) / (G + C) */
+  CPG_OE,     /**< CpG observed / expected, CpG * length / (C * G) */
+  N_FRACTION, /**< Fraction of N */
+  SOFT_MASKED /**< Fraction of lowercase bases */
+};
+
+/**
+ * @brief Sliding window composition tracks in bedGraph format
+ *
+ * Every enabled track is written to its own stream. Windows are walked
+ * with `window_iterator`, so each base is counted once per track set,
+ * independent of the window width. Each window is reported for the
+ * interval from its start to the start of the next window (or its end,
+ * whichever comes first), so overlapping windows still give a valid
+ * bedGraph. Adjacent intervals with the same value are merged, windows
+ * without a defined value (e.g. GC of an all-N window) are left out.
+ */
+class CompositionTracks
+{
+public:
+  /**
+   * @brief Constructor
+   *
+   * @param width The window width
+   * @param step The window increment
+   * @param include_final Should the final (incomplete) window be reported
+   */
+  CompositionTracks(length_t width, length_t step,
+                    bool include_final = false);
+
+  /**
+   * @brief Enable a track
+   *
+   * @param track The track type
+   * @param out The stream the bedGraph lines are written to
+   */
+  void add(CompositionTrack track, std::ostream& out);
+
+  /**
+   * @brief Compute the tracks of a record
+   *
+   * @param r A record, the chromosome name is its canonical ID
+   * @return The bedGraph lines, one string per enabled track
+   */
+  std::vector<std::string> bedgraph(const Record& r) const;
+
+  /**
+   * @brief Compute and write the tracks of a batch of records
+   *
+   * Records are processed in parallel if the library was built with
+   * OpenMP and written in the order of the batch.
+   *
+   * @param batch A vector of records, e.g. from `Reader::next_batch()`
+   */
+  void write(const std::vector<Record>& batch);
+
+  /**
+   * @brief Value of a track for a window
+   *
+   * @param track The track type
+   * @param counts The counts of the window
+   * @param value Set to the value, if it is defined
+   * @return False if the value is undefined for this window
+   */
+  static bool value(CompositionTrack track, const WindowCounts& counts,
+                    double& value);
+
+  /**
+   * @brief Short name of a track (gc, gc_skew, cpg_oe, n, masked)
+   */
+  static std::string name(CompositionTrack track);
+
+  /**
+   * @brief Track type from its short name, see `name()`
+   */
+  static CompositionTrack parse(const std::string& name);
+
+private:
+  length_t _width;
+  length_t _step;
+  bool _include_final;
+  std::vector<CompositionTrack> _tracks;
+  std::vector<std::ostream*> _outs;
+};
+
+}
+#endif
@@ -0,0 +1,176 @@
+#include <string>
+#include <array>
+#include <vector>
+#include <map>
+#include <stdexcept>
+#include <fastxio_common.h>
+#include <fastxio_translate.h>
+
+namespace FASTX {
+
+namespace {
+
+struct genetic_code_t
+{
+  unsigned short id;
+  const char * aa; // 64 amino acids, codons in NCBI TCAG order
+};
+
+const genetic_code_t ncbi_codes[] = {
+  {1,  "FFLLSSSSYY**CC*WLLLLPPPPHHQQRRRRIIIMTTTTNNKKSSRRVVVVAAAADDEEGGGG"},
+  {2,  "FFLLSSSSYY**CCWWLLLLPPPPHHQQRRRRIIMMTTTTNNKKSS**VVVVAAAADDEEGGGG"},
+  {3,  "FFLLSSSSYY**CCWWTTTTPPPPHHQQRRRRIIMMTTTTNNKKSSRRVVVVAAAADDEEGGGG"},
+  {4,  "FFLLSSSSYY**CCWWLLLLPPPPHHQQRRRRIIIMTTTTNNKKSSRRVVVVAAAADDEEGGGG"},
+  {5,  "FFLLSSSSYY**CCWWLLLLPPPPHHQQRRRRIIMMTTTTNNKKSSSSVVVVAAAADDEEGGGG"},
+  {6,  "FFLLSSSSYYQQCC*WLLLLPPPPHHQQRRRRIIIMTTTTNNKKSSRRVVVVAAAADDEEGGGG"},
+  {9,  "FFLLSSSSYY**CCWWLLLLPPPPHHQQRRRRIIIMTTTTNNNKSSSSVVVVAAAADDEEGGGG"},
+  {10, "FFLLSSSSYY**CCCWLLLLPPPPHHQQRRRRIIIMTTTTNNKKSSRRVVVVAAAADDEEGGGG"},
+  {11, "FFLLSSSSYY**CC*WLLLLPPPPHHQQRRRRIIIMTTTTNNKKSSRRVVVVAAAADDEEGGGG"},
+  {12, "FFLLSSSSYY**CC*WLLLSPPPPHHQQRRRRIIIMTTTTNNKKSSRRVVVVAAAADDEEGGGG"},
+  {13, "FFLLSSSSYY**CCWWLLLLPPPPHHQQRRRRIIMMTTTTNNKKSSGGVVVVAAAADDEEGGGG"},
+  {14, "FFLLSSSSYYY*CCWWLLLLPPPPHHQQRRRRIIIMTTTTNNNKSSSSVVVVAAAADDEEGGGG"},
+  {16, "FFLLSSSSYY*LCC*WLLLLPPPPHHQQRRRRIIIMTTTTNNKKSSRRVVVVAAAADDEEGGGG"},
+  {21, "FFLLSSSSYY**CCWWLLLLPPPPHHQQRRRRIIMMTTTTNNNKSSSSVVVVAAAADDEEGGGG"},
+  {22, "FFLLSS*SYY*LCC*WLLLLPPPPHHQQRRRRIIIMTTTTNNKKSSRRVVVVAAAADDEEGGGG"},
+  {23, "FF*LSSSSYY**CC*WLLLLPPPPHHQQRRRRIIIMTTTTNNKKSSRRVVVVAAAADDEEGGGG"},
+  {24, "FFLLSSSSYY**CCWWLLLLPPPPHHQQRRRRIIIMTTTTNNKKSSSKVVVVAAAADDEEGGGG"},
+  {25, "FFLLSSSSYY**CCGWLLLLPPPPHHQQRRRRIIIMTTTTNNKKSSRRVVVVAAAADDEEGGGG"},
+  {26, "FFLLSSSSYY**CC*WLLLAPPPPHHQQRRRRIIIMTTTTNNKKSSRRVVVVAAAADDEEGGGG"},
+  {27, "FFLLSSSSYYQQCCWWLLLLPPPPHHQQRRRRIIIMTTTTNNKKSSRRVVVVAAAADDEEGGGG"},
+  {28, "FFLLSSSSYYQQCCWWLLLLPPPPHHQQRRRRIIIMTTTTNNKKSSRRVVVVAAAADDEEGGGG"},
+  {29, "FFLLSSSSYYYYCC*WLLLLPPPPHHQQRRRRIIIMTTTTNNKKSSRRVVVVAAAADDEEGGGG"},
+  {30, "FFLLSSSSYYEECC*WLLLLPPPPHHQQRRRRIIIMTTTTNNKKSSRRVVVVAAAADDEEGGGG"},
+  {31, "FFLLSSSSYYEECCWWLLLLPPPPHHQQRRRRIIIMTTTTNNKKSSRRVVVVAAAADDEEGGGG"},
+  {32, "FFLLSSSSYY*WCC*WLLLLPPPPHHQQRRRRIIIMTTTTNNKKSSRRVVVVAAAADDEEGGGG"},
+  {33, "FFLLSSSSYYY*CCWWLLLLPPPPHHQQRRRRIIIMTTTTNNKKSSSKVVVVAAAADDEEGGGG"}
+};
+
+// Position of the mask bits A, C, G, T in NCBI TCAG order
+const unsigned short ncbi_pos[4] = {2, 1, 3, 0};
+
+// Complement of a 4-bit IUPAC mask (A <-> T, C <-> G)
+std::array<unsigned char, 16> make_mask_complement(void)
+{
+  std::array<unsigned char, 16> ret;
+  for (unsigned m = 0; m < 16; m++)
+  {
+    ret[m] = ((m & 1) << 3) | ((m & 8) >> 3) | ((m & 2) << 1) | ((m & 4) >> 1);
+  }
+  return ret;
+}
+
+const std::array<unsigned char, 16> mask_complement = make_mask_complement();
+
+} // anonymous namespace
+
+Translator::Translator(unsigned short table) : _table(table)
+{
+  const char * code = nullptr;
+  for (auto& c : ncbi_codes)
+  {
+    if (c.id == table)
+      code = c.aa;
+  }
+  if (code == nullptr)
+    throw std::runtime_error("Unknown genetic code table: " +
+                             std::to_string(table));
+
+  for (unsigned i = 0; i < _lut.size(); i++)
+  {
+    unsigned m[3] = {(i >> 8) & 0xf, (i >> 4) & 0xf, i & 0xf};
+    char aa = 0;
+    for (unsigned b0 = 0; b0 < 4; b0++)
+    {
+      if (! ((m[0] >> b0) & 1)) continue;
+      for (unsigned b1 = 0; b1 < 4; b1++)
+      {
+        if (! ((m[1] >> b1) & 1)) continue;
+        for (unsigned b2 = 0; b2 < 4; b2++)
+        {
+          if (! ((m[2] >> b2) & 1)) continue;
+          char x = code[ncbi_pos[b0] * 16 + ncbi_pos[b1] * 4 + ncbi_pos[b2]];
+          aa = (aa == 0 || aa == x) ? x : 'X';
+        }
+      }
+    }
+    _lut[i] = aa == 0 ? 'X' : aa;
+  }
+}
+
+const Translator& Translator::get(unsigned short table)
+{
+  static const std::map<unsigned short, Translator> cache = [] {
+    std::map<unsigned short, Translator> ret;
+    for (auto& c : ncbi_codes)
+      ret.emplace(c.id, Translator(c.id));
+    return ret;
+  }();
+  auto it = cache.find(table);
+  if (it == cache.end())
+    throw std::runtime_error("Unknown genetic code table: " +
+                             std::to_string(table));
+  return it->second;
+}
+
+std::vector<unsigned short> Translator::tables(void)
+{
+  std::vector<unsigned short> ret;
+  for (auto& c : ncbi_codes)
+    ret.push_back(c.id);
+  return ret;
+}
+
+std::string Translator::translate(const char * seq, length_t len,
+                                  unsigned short frame) const
+{
+  std::string ret;
+  if (len < frame + 3u)
+    return ret;
+  ret.resize((len - frame) / 3);
+  char * out = &ret[0];
+  for (length_t i = frame; i + 2 < len; i += 3)
+  {
+    *out++ = _lut[index(seq[i], seq[i + 1], seq[i + 2])];
+  }
+  return ret;
+}
+
+// A codon starting at position i belongs to forward frame i % 3 and to
+// reverse frame (len - 3 - i) % 3. Forward frames are filled front to back,
+// reverse frames back to front.
+void Translator::six_frame(const char * seq, length_t len,
+                           std::array<std::string, 6>& frames) const
+{
+  char * fwd[3];
+  char * rev[3];
+  for (unsigned short f = 0; f < 3; f++)
+  {
+    length_t n = len >= f + 3u ? (len - f) / 3 : 0;
+    frames[f].resize(n);
+    frames[f + 3].resize(n);
+    fwd[f] = &frames[f][0];
+    rev[f] = &frames[f + 3][0] + n;
+  }
+  if (len < 3)
+    return;
+
+  unsigned short fidx = 0;
+  unsigned short ridx = 0;
+  unsigned short f = 0;
+  unsigned short r = (len - 3) % 3;
+  for (length_t i = 0; i < len; i++)
+  {
+    unsigned char m = GData::iupac_mask[static_cast<unsigned char>(seq[i])];
+    fidx = ((fidx << 4) | m) & 0xfff;
+    ridx = (ridx >> 4) | (mask_complement[m] << 8);
+    if (i >= 2)
+    {
+      *fwd[f]++ = _lut[fidx];
+      *--rev[r] = _lut[ridx];
+      f = f == 2 ? 0 : f + 1;
+      r = r == 0 ? 2 : r - 1;
+    }
+  }
+}
+
+}
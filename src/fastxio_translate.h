@@ -0,0 +1,107 @@
+#ifndef _FASTX_IO_TRANSLATE_H_
+#define _FASTX_IO_TRANSLATE_H_
+
+#include <string>
+#include <array>
+#include <vector>
+#include <fastxio_common.h>
+
+namespace FASTX {
+
+/**
+ * @brief Codon to amino acid translation engine.
+ *
+ * Codons are encoded as three 4-bit IUPAC masks (see `GData::iupac_mask`)
+ * and looked up in a flat table of 4096 amino acids. Ambiguous codons
+ * translate to the amino acid all of their possibilities agree on (e.g.
+ * `GGN` to `G`), or to `X` otherwise. DNA and RNA are handled alike.
+ * Stop codons are translated to `*`.
+ *
+ * All NCBI genetic code tables are supported, see `Translator::tables()`.
+ */
+class Translator {
+public:
+  /**
+   * @brief Build the lookup table for a genetic code.
+   *
+   * Building a table is cheap, but not free. Use `Translator::get()` to
+   * share translators.
+   *
+   * @param table The NCBI genetic code table ID (1 is the standard code,
+   * 11 the bacterial, archaeal and plant plastid code)
+   */
+  explicit Translator(unsigned short table = 1);
+
+  /**
+   * @brief Get a shared translator for a genetic code.
+   *
+   * @param table The NCBI genetic code table ID
+   * @return A reference to a translator that lives until program exit
+   */
+  static const Translator& get(unsigned short table = 1);
+
+  /**
+   * @brief Get the IDs of all supported NCBI genetic code tables.
+   *
+   * @return A vector of table IDs
+   */
+  static std::vector<unsigned short> tables(void);
+
+  /**
+   * @brief Translate a single codon.
+   *
+   * @param codon Pointer to three nucleotides
+   * @return The amino acid
+   */
+  char codon(const char * codon) const {
+    return _lut[index(codon[0], codon[1], codon[2])];
+  }
+
+  /**
+   * @brief Translate one reading frame.
+   *
+   * @param seq Pointer to the nucleotide sequence
+   * @param len Length of the sequence
+   * @param frame The reading frame: 0 for the first base, 1 or 2 for the next
+   * @return The amino acid sequence
+   */
+  std::string translate(const char * seq, length_t len,
+                        unsigned short frame) const;
+
+  /**
+   * @brief Translate all six reading frames in one pass.
+   *
+   * Frames 0-2 are the forward frames starting at the first, second and
+   * third base. Frames 3-5 are the frames 0-2 of the reverse complement.
+   *
+   * @param seq Pointer to the nucleotide sequence
+   * @param len Length of the sequence
+   * @param frames Array of output strings, overwritten
+   */
+  void six_frame(const char * seq, length_t len,
+                 std::array<std::string, 6>& frames) const;
+
+  /**
+   * @brief Get the genetic code table ID.
+   *
+   * @return The NCBI table ID
+   */
+  unsigned short table(void) const { return _table; }
+
+private:
+  static unsigned short index(char a, char b, char c);
+
+  std::array<char, 4096> _lut;
+  unsigned short _table;
+};
+
+// Combine the IUPAC masks of three nucleotides to a table index
+inline unsigned short Translator::index(char a, char b, char c)
+{
+  return (GData::iupac_mask[static_cast<unsigned char>(a)] << 8) |
+         (GData::iupac_mask[static_cast<unsigned char>(b)] << 4) |
+         GData::iupac_mask[static_cast<unsigned char>(c)];
+}
+
+}
+#endif
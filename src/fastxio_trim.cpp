@@ -0,0 +1,143 @@
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <fastxio_common.h>
+#include <fastxio_record.h>
+#include <fastxio_trim.h>
+
+namespace FASTX {
+
+namespace {
+
+inline unsigned q(const char * qual, length_t i)
+{
+  return static_cast<unsigned char>(qual[i]);
+}
+
+// Start of a G rich tail, one non-G base per eight bases is tolerated
+length_t poly_g_end(const char * seq, length_t start, length_t end,
+                    length_t min_length)
+{
+  length_t mismatch = 0;
+  length_t cut = end;
+  for (length_t i = end; i > start; i--)
+  {
+    if ((seq[i - 1] | 0x20) == 'g')
+      cut = i - 1;
+    else if (++mismatch * 8 > end - i + 1)
+      break;
+  }
+  return end - cut >= min_length ? cut : end;
+}
+
+// BWA: maximize the sum of (threshold - Q) over the removed 3' bases
+length_t mott_end(const char * qual, length_t start, length_t end,
+                  unsigned threshold)
+{
+  int64_t sum = 0;
+  int64_t best = 0;
+  length_t cut = end;
+  for (length_t i = end; i > start; i--)
+  {
+    sum += static_cast<int64_t>(threshold) - q(qual, i - 1);
+    if (sum < 0)
+      break;
+    if (sum > best)
+    {
+      best = sum;
+      cut = i - 1;
+    }
+  }
+  return cut;
+}
+
+length_t leading_start(const char * qual, length_t start, length_t end,
+                       unsigned threshold)
+{
+  while (start < end && q(qual, start) < threshold)
+    start++;
+  return start;
+}
+
+// Cut at the first window with a mean below the threshold, but keep the
+// good bases at the start of that window
+length_t window_end(const char * qual, length_t start, length_t end,
+                    length_t width, unsigned threshold)
+{
+  if (end - start < width)
+    width = end - start;
+  if (width == 0)
+    return end;
+  uint64_t need = static_cast<uint64_t>(threshold) * width;
+  uint64_t sum = 0;
+  for (length_t i = start; i < start + width; i++)
+    sum += q(qual, i);
+  for (length_t i = start; ; i++)
+  {
+    if (sum < need)
+    {
+      length_t cut = i;
+      while (cut < i + width && q(qual, cut) >= threshold)
+        cut++;
+      return cut;
+    }
+    if (i + width >= end)
+      break;
+    sum += q(qual, i + width);
+    sum -= q(qual, i);
+  }
+  return end;
+}
+
+} // anonymous namespace
+
+trim_t Trimmer::coordinates(const Record& rec) const
+{
+#ifndef NO_ERROR_CHECKING
+  if (uses_quality() && (rec.get_type() & FASTA_TYPE))
+    throw std::runtime_error("FASTA files do not have quality values");
+#endif
+  const char * seq = rec.get_seq().data();
+  const char * qual = rec.get_qual().data();
+  trim_t ret;
+  ret.end = rec.size();
+  if (_poly_g > 0)
+    ret.end = poly_g_end(seq, ret.start, ret.end, _poly_g);
+  if (_quality > 0)
+    ret.end = mott_end(qual, ret.start, ret.end, _quality + _offset);
+  if (_leading > 0)
+    ret.start = leading_start(qual, ret.start, ret.end, _leading + _offset);
+  if (_window > 0)
+    ret.end = window_end(qual, ret.start, ret.end, _window,
+                         _window_threshold + _offset);
+  return ret;
+}
+
+trim_t Trimmer::trim(Record& rec) const
+{
+  trim_t ret = coordinates(rec);
+  rec.trim(ret.start, ret.end);
+  return ret;
+}
+
+std::vector<trim_t> Trimmer::trim(std::vector<Record>& batch) const
+{
+#ifndef NO_ERROR_CHECKING
+  // Exceptions must not escape the parallel region
+  for (auto& rec : batch)
+  {
+    if (uses_quality() && (rec.get_type() & FASTA_TYPE))
+      throw std::runtime_error("FASTA files do not have quality values");
+  }
+#endif
+  std::vector<trim_t> ret(batch.size());
+  int64_t n = batch.size();
+  #pragma omp parallel for schedule(static)
+  for (int64_t i = 0; i < n; i++)
+  {
+    ret[i] = trim(batch[i]);
+  }
+  return ret;
+}
+
+}
@@ -0,0 +1,125 @@
+#ifndef _FASTX_IO_TRIM_H_
+#define _FASTX_IO_TRIM_H_
+
+#include <vector>
+#include <fastxio_common.h>
+#include <fastxio_record.h>
+
+namespace FASTX {
+
+/**
+ * @brief Coordinates of the part of a record that was kept by trimming.
+ */
+struct trim_t
+{
+  length_t start = 0; /**< First kept position (0-offset) */
+  length_t end = 0;   /**< Position after the last kept base */
+};
+
+/**
+ * @brief Quality and poly-G trimming of records.
+ *
+ * The trimmer is configured once and can then be applied to records, or
+ * batches of records (see `Reader::next_batch()`), from several threads.
+ * All enabled steps run in the following order, each one on the part of
+ * the read that was kept by the steps before it:
+ *
+ * 1. Poly-G tails (NextSeq/NovaSeq two-colour chemistry), at most one
+ *    non-G base per eight bases
+ * 2. BWA style 3' quality trimming (Mott's algorithm)
+ * 3. Leading 5' bases below a quality threshold
+ * 4. Sliding window: cut where the mean quality of a window first drops
+ *    below a threshold
+ *
+ * Records are trimmed in place, without reallocating. The kept
+ * coordinates are returned instead of being appended to the ID.
+ */
+class Trimmer {
+public:
+  /**
+   * @brief Constructor. All trimming steps are disabled.
+   *
+   * @param offset The PHRED offset, see `scan_phred()`
+   */
+  explicit Trimmer(unsigned short offset = 33) : _offset(offset) {}
+
+  /**
+   * @brief Enable trimming of poly-G tails.
+   *
+   * @param min_length Minimum length of a tail to be trimmed (0 disables)
+   */
+  void set_poly_g(length_t min_length = 10) { _poly_g = min_length; }
+
+  /**
+   * @brief Enable BWA style 3' quality trimming.
+   *
+   * The read is cut at the position that maximizes the sum of
+   * (threshold - Q) over the removed bases.
+   *
+   * @param threshold The quality threshold (0 disables)
+   */
+  void set_quality(unsigned short threshold) { _quality = threshold; }
+
+  /**
+   * @brief Enable trimming of low quality 5' bases.
+   *
+   * @param threshold Leading bases below this quality are removed (0 disables)
+   */
+  void set_leading(unsigned short threshold) { _leading = threshold; }
+
+  /**
+   * @brief Enable sliding window trimming.
+   *
+   * @param width The window width (0 disables)
+   * @param threshold The minimum mean quality within a window
+   */
+  void set_sliding_window(length_t width, unsigned short threshold) {
+    _window = width;
+    _window_threshold = threshold;
+  }
+
+  /**
+   * @brief Compute the trimming coordinates of a record without trimming it.
+   *
+   * @param rec A record
+   * @return The kept coordinates [start, end)
+   */
+  trim_t coordinates(const Record& rec) const;
+
+  /**
+   * @brief Trim a record in place.
+   *
+   * @param rec A record
+   * @return The kept coordinates [start, end) of the original record
+   */
+  trim_t trim(Record& rec) const;
+
+  /**
+   * @brief Trim a batch of records in place, in parallel if the library
+   * was built with OpenMP.
+   *
+   * @param batch A vector of records
+   * @return The kept coordinates, one per record
+   */
+  std::vector<trim_t> trim(std::vector<Record>& batch) const;
+
+private:
+  bool uses_quality(void) const {
+    return _quality > 0 || _leading > 0 || _window > 0;
+  }
+
+  unsigned short _offset;
+  length_t _poly_g = 0;
+  unsigned short _quality = 0;
+  unsigned short _leading = 0;
+  length_t _window = 0;
+  unsigned short _window_threshold = 0;
+
+  /**
+   * Examples
+   *  @example trim.cpp
+   */
+};
+
+}
+#endif
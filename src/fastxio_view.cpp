@@ -0,0 +1,123 @@
+#include <array>
+#include <cctype>
+#include <stdexcept>
+#include <fastxio_common.h>
+#include <fastxio_record.h>
+#include <fastxio_view.h>
+
+namespace FASTX {
+
+const std::array<unsigned char, 256>& WindowCounts::flags(void)
+{
+  static const std::array<unsigned char, 256> ret = [] {
+    std::array<unsigned char, 256> f;
+    f.fill(0);
+    for (int c = 'a'; c <= 'z'; c++)
+      f[c] |= LOWER_FLAG;
+    for (char c : {'G', 'g', 'C', 'c', 'S', 's'})
+      f[static_cast<unsigned char>(c)] |= GC_FLAG;
+    f['G'] |= G_FLAG;
+    f['g'] |= G_FLAG;
+    f['C'] |= C_FLAG;
+    f['c'] |= C_FLAG;
+    f['N'] |= N_FLAG;
+    f['n'] |= N_FLAG;
+    return f;
+  }();
+  return ret;
+}
+
+void WindowCounts::clear(void)
+{
+  _counts.fill(0);
+  _size = 0;
+  _gc = 0;
+  _g = 0;
+  _c = 0;
+  _n = 0;
+  _lower = 0;
+  _cpg = 0;
+}
+
+window_iterator::window_iterator(length_t width, length_t increment,
+                                 const Record& r, bool include_final) :
+  _seq(r.get_seq().data()),
+  _qual(r.get_type() & FASTQ_TYPE ? r.get_qual().data() : nullptr),
+  _len(r.size()), _width(width), _increment(increment),
+  _include_final(include_final)
+{
+  init();
+}
+
+window_iterator::window_iterator(length_t width, length_t increment,
+                                 const char * seq, length_t len,
+                                 bool include_final) :
+  _seq(seq), _qual(nullptr), _len(len), _width(width),
+  _increment(increment), _include_final(include_final)
+{
+  init();
+}
+
+void window_iterator::init(void)
+{
+#ifndef NO_ERROR_CHECKING
+  if (_width == 0 || _increment == 0)
+    throw std::runtime_error("Window width and increment must be positive");
+#endif
+  _start = 0;
+  _stop = 0;
+  _end = false;
+  if (_len >= _width)
+    move_to(0, _width);
+  else if (_include_final && _len > 0)
+    move_to(0, _len);
+  else
+    _end = true;
+}
+
+window_iterator& window_iterator::operator++()
+{
+  if (_end)
+    return *this;
+  length_t next = _start + _increment;
+  if (next + _width <= _len)
+    move_to(next, next + _width);
+  else if (_include_final && next < _len)
+    move_to(next, _len);
+  else
+    _end = true;
+  return *this;
+}
+
+// Slide the counts from [_start, _stop) to [start, stop)
+void window_iterator::move_to(length_t start, length_t stop)
+{
+  if (start >= _stop)
+  {
+    _counts.clear();
+    for (length_t i = start; i < stop; i++)
+    {
+      if (i > start)
+        _counts.add_pair(_seq[i - 1], _seq[i]);
+      _counts.add(_seq[i]);
+    }
+  }
+  else
+  {
+    for (length_t i = _start; i < start; i++)
+    {
+      _counts.remove(_seq[i]);
+      if (i + 1 < _stop)
+        _counts.remove_pair(_seq[i], _seq[i + 1]);
+    }
+    for (length_t i = _stop; i < stop; i++)
+    {
+      _counts.add_pair(_seq[i - 1], _seq[i]);
+      _counts.add(_seq[i]);
+    }
+  }
+  _start = start;
+  _stop = stop;
+}
+
+}
@@ -0,0 +1,305 @@
+#ifndef _FASTX_IO_VIEW_H_
+#define _FASTX_IO_VIEW_H_
+
+#include <string>
+#include <array>
+#include <ostream>
+#include <fastxio_common.h>
+#include <fastxio_record.h>
+
+namespace FASTX {
+
+/**
+ * @brief A non-owning view of a part of a sequence
+ *
+ * A view is a pointer to the sequence (and quality) plus a length. It is
+ * only valid as long as the viewed `Record` or buffer is alive and
+ * unchanged.
+ */
+class SeqView
+{
+public:
+  /**
+   * @brief Empty view
+   */
+  SeqView(void) : _seq(nullptr), _qual(nullptr), _len(0) {}
+
+  /**
+   * @brief Constructor
+   *
+   * @param seq Pointer to the first base
+   * @param qual Pointer to the first quality value, nullptr for FASTA
+   * @param len Number of bases
+   */
+  SeqView(const char * seq, const char * qual, length_t len) :
+    _seq(seq), _qual(qual), _len(len) {}
+
+  /**
+   * @brief Pointer to the sequence
+   */
+  const char * data(void) const { return _seq; }
+
+  /**
+   * @brief Pointer to the quality values, nullptr for FASTA
+   */
+  const char * qual(void) const { return _qual; }
+
+  /**
+   * @brief Number of bases
+   */
+  length_t size(void) const { return _len; }
+
+  /**
+   * @brief Base at a position of the view
+   */
+  char operator[](length_t i) const { return _seq[i]; }
+
+  /**
+   * @brief Copy the sequence
+   */
+  std::string str(void) const { return std::string(_seq, _len); }
+
+  /**
+   * @brief Copy the quality string (empty for FASTA)
+   */
+  std::string qual_str(void) const {
+    return _qual ? std::string(_qual, _len) : std::string();
+  }
+
+private:
+  const char * _seq;
+  const char * _qual;
+  length_t _len;
+};
+
+/**
+ * @brief Print the sequence of a view
+ */
+inline std::ostream& operator<<(std::ostream& outstream, const SeqView& v)
+{
+  return outstream.write(v.data(), v.size());
+}
+
+/**
+ * @brief Nucleotide counts of a window, updated base by base
+ *
+ * Bases are added to the right end and removed from the left end of the
+ * window, each in O(1). Besides the count of every character, the
+ * counters commonly used for composition tracks are kept up to date. The
+ * CpG count needs the neighbouring base, see `add_pair()`.
+ */
+class WindowCounts
+{
+public:
+  WindowCounts(void) { clear(); }
+
+  /**
+   * @brief Reset all counts to zero
+   */
+  void clear(void);
+
+  /**
+   * @brief Add a base
+   */
+  void add(char c) {
+    unsigned char u = static_cast<unsigned char>(c);
+    unsigned char f = flags()[u];
+    _counts[u]++;
+    _size++;
+    _gc += f & GC_FLAG;
+    _n += (f & N_FLAG) >> 1;
+    _lower += (f & LOWER_FLAG) >> 2;
+    _g += (f & G_FLAG) >> 3;
+    _c += (f & C_FLAG) >> 4;
+  }
+
+  /**
+   * @brief Remove a base
+   */
+  void remove(char c) {
+    unsigned char u = static_cast<unsigned char>(c);
+    unsigned char f = flags()[u];
+    _counts[u]--;
+    _size--;
+    _gc -= f & GC_FLAG;
+    _n -= (f & N_FLAG) >> 1;
+    _lower -= (f & LOWER_FLAG) >> 2;
+    _g -= (f & G_FLAG) >> 3;
+    _c -= (f & C_FLAG) >> 4;
+  }
+
+  /**
+   * @brief Add a pair of adjacent bases (a followed by b)
+   */
+  void add_pair(char a, char b) { _cpg += is_cpg(a, b); }
+
+  /**
+   * @brief Remove a pair of adjacent bases (a followed by b)
+   */
+  void remove_pair(char a, char b) { _cpg -= is_cpg(a, b); }
+
+  /**
+   * @brief Number of occurrences of a character
+   */
+  length_t count(char c) const { return _counts[static_cast<unsigned char>(c)]; }
+
+  /**
+   * @brief Counts of all characters
+   */
+  const std::array<length_t, 256>& counts(void) const { return _counts; }
+
+  /**
+   * @brief Number of bases
+   */
+  length_t size(void) const { return _size; }
+
+  /**
+   * @brief Number of G, C and S, in either case
+   */
+  length_t gc(void) const { return _gc; }
+
+  /**
+   * @brief Number of G, in either case
+   */
+  length_t g(void) const { return _g; }
+
+  /**
+   * @brief Number of C, in either case
+   */
+  length_t c(void) const { return _c; }
+
+  /**
+   * @brief Number of N, in either case
+   */
+  length_t n(void) const { return _n; }
+
+  /**
+   * @brief Number of soft-masked (lowercase) characters
+   */
+  length_t soft_masked(void) const { return _lower; }
+
+  /**
+   * @brief Number of CpG dinucleotides, in either case
+   */
+  length_t cpg(void) const { return _cpg; }
+
+private:
+  static const unsigned char GC_FLAG = 1;
+  static const unsigned char N_FLAG = 2;
+  static const unsigned char LOWER_FLAG = 4;
+  static const unsigned char G_FLAG = 8;
+  static const unsigned char C_FLAG = 16;
+
+  static const std::array<unsigned char, 256>& flags(void);
+
+  static length_t is_cpg(char a, char b) {
+    return (a | 0x20) == 'c' && (b | 0x20) == 'g';
+  }
+
+  std::array<length_t, 256> _counts;
+  length_t _size;
+  length_t _gc;
+  length_t _g;
+  length_t _c;
+  length_t _n;
+  length_t _lower;
+  length_t _cpg;
+};
+
+/**
+ * @brief Zero-copy sliding windows along a sequence
+ *
+ * Yields `SeqView` objects instead of `Record` copies and keeps
+ * `WindowCounts` of the current window, updated only with the bases that
+ * enter and leave the window. Walking a sequence of length n is O(n)
+ * regardless of the window width, as long as the increment is not larger
+ * than the width.
+ *
+ * Windows are placed like `window_walker`: [i * increment,
+ * i * increment + width) as long as they fit. If `include_final` is set,
+ * they are followed by the incomplete windows [i * increment, length) for
+ * every further start before the end of the sequence.
+ */
+class window_iterator
+{
+public:
+  /**
+   * @brief Constructor on a record
+   *
+   * @param width The window width
+   * @param increment The increment of the window
+   * @param r A `Record` object, which has to outlive the iterator
+   * @param include_final Should the final (incomplete) window be returned
+   */
+  window_iterator(length_t width, length_t increment, const Record& r,
+                  bool include_final = false);
+
+  /**
+   * @brief Constructor on a raw sequence
+   *
+   * @param width The window width
+   * @param increment The increment of the window
+   * @param seq Pointer to the sequence
+   * @param len Length of the sequence
+   * @param include_final Should the final (incomplete) window be returned
+   */
+  window_iterator(length_t width, length_t increment,
+                  const char * seq, length_t len,
+                  bool include_final = false);
+
+  /**
+   * @brief Move to the next window
+   */
+  window_iterator& operator++();
+
+  /**
+   * @brief Check if all windows have been visited
+   */
+  bool end(void) const { return _end; }
+
+  /**
+   * @brief View of the current window
+   */
+  SeqView operator*() const {
+    return SeqView(_seq + _start, _qual ? _qual + _start : nullptr,
+                   _stop - _start);
+  }
+
+  /**
+   * @brief Start of the current window (0-offset)
+   */
+  length_t start(void) const { return _start; }
+
+  /**
+   * @brief End of the current window (exclusive)
+   */
+  length_t stop(void) const { return _stop; }
+
+  /**
+   * @brief Counts of the current window
+   */
+  const WindowCounts& counts(void) const { return _counts; }
+
+private:
+  void init(void);
+  void move_to(length_t start, length_t stop);
+
+  const char * _seq;
+  const char * _qual;
+  length_t _len;
+  length_t _width;
+  length_t _increment;
+  length_t _start;
+  length_t _stop;
+  bool _include_final;
+  bool _end;
+  WindowCounts _counts;
+
+  /**
+   * Examples
+   *  @example generate_window.cpp
+   */
+};
+
+}
+#endif